@@ -168,6 +168,7 @@ JSByteArray::JSByteArray( v8::Handle<v8::Value> const & val, unsigned int len )
 void JSByteArray::swapBuffer( BufferType & buf )
 {
     this->vec.swap(buf);
+    cv::ClassCreator<JSByteArray>::ExternalMemoryResized( this );
 }
 
 v8::Handle<v8::Value> JSByteArray::indexedPropertyGetter(uint32_t index, const v8::AccessorInfo &info)
@@ -320,12 +321,8 @@ uint32_t JSByteArray::length( uint32_t sz )
     }
     if( sz != this->vec.size() )
     {
-        if( ! this->vec.empty() )
-        {
-            v8::V8::AdjustAmountOfExternalAllocatedMemory( - static_cast<int>(this->vec.size()) );
-        }
         this->vec.resize(sz,0);
-        v8::V8::AdjustAmountOfExternalAllocatedMemory( static_cast<int>(this->vec.size()) );
+        cv::ClassCreator<JSByteArray>::ExternalMemoryResized( this );
     }
     return this->vec.size();
 }
@@ -337,10 +334,12 @@ void JSByteArray::append( void const * src, unsigned int len )
     this->vec.reserve( newLen );
     unsigned char const * beg = (unsigned char const *)src;
     std::copy( beg, beg + len, std::back_inserter(this->vec) );
+    cv::ClassCreator<JSByteArray>::ExternalMemoryResized( this );
 }
 void JSByteArray::append( JSByteArray const & other )
 {
     std::copy( other.vec.begin(), other.vec.end(), std::back_inserter(this->vec) );
+    cv::ClassCreator<JSByteArray>::ExternalMemoryResized( this );
 }
 
 
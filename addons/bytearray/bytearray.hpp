@@ -212,6 +212,16 @@ namespace cvv8 {
         static void Delete( JSByteArray * obj );
     };
 
+    /** Reports the byte array's buffer to v8 as external memory. */
+    template <>
+    struct ClassCreator_ExternalMemory<JSByteArray> : Opt_Bool<true>
+    {
+        static std::size_t Size( JSByteArray const & ba )
+        {
+            return ba.length();
+        }
+    };
+
     template <>
     struct JSToNative< JSByteArray > : JSToNative_ClassCreator< JSByteArray >
     {};
@@ -73,7 +73,7 @@ namespace expat {
         */
         v8::Handle<v8::Value> userData()
         {
-            const v8::Handle<v8::Value> rc = this->jself->Get( JSTR(Strings::userData) );
+            const v8::Handle<v8::Value> rc = this->jself->Get( SymbolCache::Get(Strings::userData) );
             if( rc.IsEmpty() ) return v8::Undefined();
             else return rc;
         }
@@ -111,7 +111,7 @@ namespace expat {
                 TOSSV(msg);
                 return;
             }
-            this->jself->Set( JSTR(n), FuncHnd( v8::Function::Cast(*func) ) );
+            this->jself->Set( SymbolCache::Get(n), FuncHnd( v8::Function::Cast(*func) ) );
         }
         /**
            Gets the handler callback function associated with n, or an
@@ -119,7 +119,7 @@ namespace expat {
         */
         FuncHnd getHandler( char const * n )
         {
-            ValHnd const h = this->jself->Get( JSTR(n) );
+            ValHnd const h = this->jself->Get( SymbolCache::Get(n) );
             return (!h.IsEmpty() && h->IsFunction() )
                 ? FuncHnd( v8::Function::Cast(*h) )
                 : FuncHnd();
@@ -288,7 +288,7 @@ namespace cvv8 { namespace expat {
         }
         {
             v8::Handle<v8::ObjectTemplate> proto = cc.Prototype();
-            proto->Set( JSTR(Strings::userData), v8::Undefined() );
+            proto->Set( SymbolCache::Get(Strings::userData), v8::Undefined() );
 
         }
 
@@ -738,7 +738,7 @@ v8::Handle<v8::Value> Statement_stepObject( v8::Arguments const & argv )
     {
         colName = st->col_name(i);
         if( ! colName ) continue;
-        obj->Set( JSTR(colName), Statement_get(st, i) );
+        obj->Set( cv::SymbolCache::Get(colName), Statement_get(st, i) );
     }
     return hscope.Close(obj);
 }
@@ -755,7 +755,7 @@ static v8::Handle<v8::Value> Statement_getColumnNames( v8::Local< v8::String > p
         ASSERT_STMT_DECL(info.This());
         v8::Handle<v8::Object> const & self( info.This() );
         char const * prop = "columnNames";
-        v8::Handle<v8::String> const & jProp(JSTR(prop));
+        v8::Handle<v8::String> const & jProp(cv::SymbolCache::Get(prop));
         v8::Handle<v8::Value> val( self->GetHiddenValue(jProp) );
         if( val.IsEmpty() )
         {
@@ -856,7 +856,7 @@ static v8::Handle<v8::Value> Statement_getParamNames( v8::Local< v8::String > pr
         ASSERT_STMT_DECL(info.This());
         v8::Handle<v8::Object> const & self( info.This() );
         char const * prop = "columnNames";
-        v8::Handle<v8::String> const & jProp(JSTR(prop));
+        v8::Handle<v8::String> const & jProp(cv::SymbolCache::Get(prop));
         v8::Handle<v8::Value> val( self->GetHiddenValue(jProp) );
         if( val.IsEmpty() )
         {
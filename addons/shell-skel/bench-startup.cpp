@@ -0,0 +1,115 @@
+/**
+   Startup-time benchmark for shells built from shell-skel: measures
+   how long it takes to create a shell context and install the
+   bindings of the add-ons which have no third-party dependencies
+   (ByteArray, Socket, PathFinder, sprintf, glob and the time
+   functions), once eagerly, by calling their setup functions, and
+   once lazily, via cvv8::LazyBinding.
+
+   The first context of a process pays for building each class'
+   function templates, so that is measured in a fresh process for
+   each mode. The later contexts only instantiate the functions from
+   the existing templates, and are measured as an average over a
+   number of rounds. Each context then runs the given script (by
+   default one which uses only one of the add-ons), so that the lazy
+   mode's deferred setup cost is counted as well.
+
+   Usage: ./bench-startup eager|lazy [rounds [script]]
+
+   Run it once per mode, e.g.:
+
+   for m in eager lazy; do ./bench-startup $m; done
+*/
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#include "cvv8/v8-convert.hpp"
+#include "cvv8/V8Shell.hpp"
+#include "bytearray.hpp"
+#include "socket.hpp"
+#include "cvv8-PathFinder.hpp"
+#include "jssprintf.hpp"
+#include "jsglob.hpp"
+#include "time.hpp"
+
+namespace {
+    typedef std::chrono::high_resolution_clock Clock;
+    namespace cv = cvv8;
+
+    /** Installs all add-on bindings in dest, the way their shells do. */
+    void setupEager( v8::Handle<v8::Object> const & dest )
+    {
+        cv::JSByteArray::SetupBindings( dest );
+        cv::JSSocket::SetupBindings( dest );
+        cv::SetupPathFinderBindings( dest );
+        cv::SetupJSPrintf( dest );
+        cv::SetupGlobBindings( dest );
+        cv::time::SetupBindings( dest );
+    }
+
+    /** Installs lazy accessors for all of the add-on bindings. */
+    void setupLazy( v8::Handle<v8::Object> const & dest )
+    {
+        cv::LazyBinding< void (v8::Handle<v8::Object>), cv::JSByteArray::SetupBindings >::Add( dest, "ByteArray" );
+        cv::LazyBinding< void (v8::Handle<v8::Object> const &), cv::JSSocket::SetupBindings >::Add( dest, "Socket" );
+        cv::LazyBinding< void (v8::Handle<v8::Object> const &), cv::SetupPathFinderBindings >::Add( dest, "PathFinder" );
+        cv::LazyBinding< void (v8::Handle<v8::Object>), cv::SetupJSPrintf >::Add( dest, "sprintf" );
+        cv::LazyBinding< void (v8::Handle<v8::Object>), cv::SetupGlobBindings >::Add( dest, "glob" );
+        typedef cv::LazyBinding< void (v8::Handle<v8::Object>), cv::time::SetupBindings > Time;
+        char const * timeFuncs[] = {
+            "sleep", "mssleep", "usleep", "wait", "mswait", "uwait"
+        };
+        for( unsigned i = 0; i < sizeof(timeFuncs)/sizeof(timeFuncs[0]); ++i )
+        {
+            Time::Add( dest, timeFuncs[i] );
+        }
+    }
+
+    /**
+       Creates a shell, installs the bindings and runs script. Returns
+       the elapsed time in microseconds, or a negative value if the
+       script fails.
+    */
+    double startShell( bool lazy, std::string const & script )
+    {
+        Clock::time_point const start = Clock::now();
+        cv::Shell shell;
+        v8::HandleScope hsc;
+        v8::Handle<v8::Object> global( shell.Global() );
+        if( lazy ) setupLazy( global );
+        else setupEager( global );
+        if( shell.ExecuteString( script ).IsEmpty() ) return -1;
+        typedef std::chrono::duration<double, std::micro> US;
+        return std::chrono::duration_cast<US>( Clock::now() - start ).count();
+    }
+}
+
+int main( int argc, char const * const * argv )
+{
+    if( (argc < 2) || (std::strcmp(argv[1], "eager") && std::strcmp(argv[1], "lazy")) )
+    {
+        std::cerr << "Usage: " << argv[0] << " eager|lazy [rounds [script]]\n";
+        return 1;
+    }
+    bool const lazy = (0 == std::strcmp(argv[1], "lazy"));
+    unsigned const rounds = (argc > 2) ? std::strtoul( argv[2], 0, 10 ) : 200;
+    std::string const script( (argc > 3) ? argv[3] : "sprintf('%d', 42)" );
+    double const first = startShell( lazy, script );
+    if( first < 0 ) return 2;
+    double later = 0;
+    for( unsigned r = 0; r < rounds; ++r )
+    {
+        double const t = startShell( lazy, script );
+        if( t < 0 ) return 2;
+        later += t;
+    }
+    std::cout << argv[1] << " bindings, script: " << script << '\n'
+              << std::fixed << std::setprecision(1)
+              << "  first context: " << std::setw(10) << first << " us\n"
+              << "  later contexts:" << std::setw(10) << (rounds ? later / rounds : 0.0)
+              << " us (average of " << rounds << ")\n";
+    return 0;
+}
@@ -36,7 +36,22 @@
    contain any client-custom bindings. See
    cvv8::V8Shell::SetupDefaultBindings() for the list of features
    added to the JS engine. In addition to those, this shell provides a
-   JS-side gc() function which is a proxy for v8::V8::IdleNotification().
+   JS-side gc() function which is a proxy for v8::V8::IdleNotification()
+   which also destroys a batch of objects queued in
+   cvv8::DeferredDeleteQueue (see cvv8::ClassCreator_DeferredDelete).
+   If built with CVV8_CONFIG_ENABLE_PROFILER=1 it also provides
+   callProfile([reset]) and callProfileJSON(), which report the
+   statistics collected by cvv8::InCaProfiler bindings. It also installs
+   the statistics functions described for cvv8::SetupStatsBindings()
+   (class and v8 lock statistics, if those are compiled in).
+
+   If built with C++11 threads (CVV8_CONFIG_HAS_STD_THREAD), the shell
+   starts the cvv8::AsyncQueue worker threads when a script makes its
+   first asynchronous call (via cvv8::FunctionToAsyncInCa and
+   friends), and after the last script has run it keeps delivering
+   their results to the scripts' callbacks until no asynchronous calls
+   are pending. Define SHELL_ASYNC_WORKERS to the number of worker
+   threads to use. The default, 0, means one per hardware thread.
 */
 
 #include <cassert>
@@ -53,20 +68,60 @@
 
 #include "cvv8/v8-convert.hpp"
 #include "cvv8/V8Shell.hpp"
+#include "cvv8/shell_stats.hpp"
+#include "cvv8/async.hpp"
 namespace cv = cvv8;
 
 #if defined(INCLUDE_SHELL_BINDINGS)
 #  include INCLUDE_SHELL_BINDINGS
 #endif
 
+/**
+   The shell's idle hook: runs v8::V8::IdleNotification(hint), then
+   destroys up to IdleDrainBatch natives whose destruction was
+   deferred out of the GC. Returns true if v8 has no more cleanup
+   work to do and no deferred destructions are pending.
+*/
+static bool shell_idle( int hint )
+{
+    enum { IdleDrainBatch = 256 };
+    bool const done = v8::V8::IdleNotification( hint );
+    cv::DeferredDeleteQueue::Drain( IdleDrainBatch );
+    return done && !cv::DeferredDeleteQueue::Pending();
+}
+
+#if CVV8_CONFIG_HAS_STD_THREAD
+#if !defined(SHELL_ASYNC_WORKERS)
+#  define SHELL_ASYNC_WORKERS 0
+#endif
+/**
+   Runs the cvv8::AsyncQueue worker threads, once the first
+   asynchronous call starts them, for the lifetime of the shell.
+*/
+struct AsyncWorkers
+{
+    AsyncWorkers() { cv::AsyncQueue::StartWorkersLazily( SHELL_ASYNC_WORKERS ); }
+    ~AsyncWorkers() { cv::AsyncQueue::StopWorkers(); }
+};
+#endif
+
 static int v8_main(int argc, char const * const * argv)
 {
     assert( argc >= 2 );
     cv::Shell shell(NULL, argc, argv);
     shell.SetupDefaultBindings()
         // Garbage collector:
-        ("gc", cv::FunctionToInCa<bool (int), v8::V8::IdleNotification>::Call )
+        ("gc", cv::FunctionToInCa<bool (int), shell_idle>::Call )
+        ;
+#if CVV8_CONFIG_ENABLE_PROFILER
+    shell("callProfile", cv::CallProfiler::StatsCallback )
+        ("callProfileJSON", cv::CallProfiler::JSONCallback )
         ;
+#endif
+    cv::SetupStatsBindings( shell.Global() );
+#if CVV8_CONFIG_HAS_STD_THREAD
+    AsyncWorkers const asyncWorkers;
+#endif
     try
     {
         
@@ -104,6 +159,18 @@ static int v8_main(int argc, char const * const * argv)
                 return 2;
             }
         }
+#if CVV8_CONFIG_HAS_STD_THREAD
+        // Deliver the results of pending asynchronous calls.
+        {
+            v8::HandleScope hsc;
+            v8::TryCatch tc;
+            while( !cv::AsyncQueue::RunLoop() )
+            {
+                shell.ReportException( &tc );
+                tc.Reset();
+            }
+        }
+#endif
     }
     catch(std::exception const & ex)
     {
@@ -29,7 +29,8 @@ castTypedefs="" # typedef ArgCaster<A#> AC#, ...
 castInits="" # AC# ac#; ...
 callArgs="" # a0, ... aN
 sigTypeDecls="" # SignatureType::ArgType# A#...
-unlocker="V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );"
+unlocker="ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );"
 at=0
 
 ########################################################
@@ -87,7 +88,7 @@ struct CtorForwarderProxy<Sig,${count}>
 {
     enum { Arity = ${count} };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -99,7 +100,7 @@ struct CtorForwarderProxy<Sig,${count}>
             ${castTypedefs}
             ${castInits}
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type( ${castCalls} );
+            return mem ? new (mem) Type( ${castCalls} ) : new Type( ${castCalls} );
         }
     }
 };
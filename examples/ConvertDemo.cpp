@@ -13,11 +13,13 @@ majority of the cvv8 testing and debugging happens.
 
 #include "cvv8/arguments.hpp"
 #include "cvv8/XTo.hpp"
+#include "cvv8/async.hpp"
 #include <time.h>
 //char const * cvv8::TypeName< BoundNative >::Value = "BoundNative";
 //char const * cvv8::TypeName< BoundSubNative >::Value = "BoundSubNative";
 
 int BoundNative::publicStaticInt = 42;
+int MIMixin::copies = 0;
 
 void doFoo()
 {
@@ -86,6 +88,9 @@ struct CurrentTimeFtor
 namespace cvv8 {
     CVV8_TypeName_IMPL((BoundNative),"BoundNative");
     CVV8_TypeName_IMPL((BoundSubNative),"BoundSubNative");
+    CVV8_TypeName_IMPL((MIMixin),"MIMixin");
+    CVV8_TypeName_IMPL((MIDerived),"MIDerived");
+    CVV8_TypeName_IMPL((DemoVec2),"DemoVec2");
 
     // A helper to support converting from BoundNative to its JS handle.
     typedef NativeToJSMap<BoundNative> BMap;
@@ -335,6 +340,17 @@ ValueHandle BoundNative_toString( v8::Arguments const & argv )
 }
 
 v8::Handle<v8::Value> bind_BoundSubNative( v8::Handle<v8::Object> dest );
+void bind_MIClasses( v8::Handle<v8::Object> dest );
+void bind_DemoVec2( v8::Handle<v8::Object> dest );
+void bind_LazyDemo( v8::Handle<v8::Object> dest );
+DemoPoint movePoint( DemoPoint p, int dx )
+{
+    p.x += dx;
+    p.y += dx;
+    p.label = "moved(" + p.label + ")";
+    return p;
+}
+
 char const * cstring_test( char const * c )
 {
     std::cerr << "cstring_test( @"<<(void const *)c
@@ -370,6 +386,39 @@ void test_using_locker()
     CERR << "We're back...\n";
 }
 
+MIMixin mixinFromValue( int v )
+{
+    MIMixin m;
+    m.mixinValue = v;
+    return m;
+}
+
+int demoDivide( int a, int b )
+{
+    if( !b ) throw std::runtime_error("demoDivide(): division by zero!");
+    return a / b;
+}
+
+#if CVV8_CONFIG_HAS_STD_THREAD && CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+/**
+   Runs the completions of pending asynchronous calls (see
+   cvv8::AsyncQueue::RunLoop()), so that test.js can check their
+   callbacks without waiting for the host application to do so.
+*/
+ValueHandle runAsyncCompletions( v8::Arguments const & )
+{
+    return cv::AsyncQueue::RunLoop()
+        ? ValueHandle( v8::Undefined() )
+        : ValueHandle() /* a callback threw: propagate it */;
+}
+#endif
+
+/** Returns true if the calling thread holds the v8 lock. */
+bool isV8Locked()
+{
+    return v8::Locker::IsLocked();
+}
+
 namespace cvv8 {
 
 
@@ -390,6 +439,9 @@ namespace cvv8 {
             {
                 cc.AddClassTo( TypeName<BN>::Value, dest );
                 bind_BoundSubNative(dest);
+                bind_MIClasses(dest);
+                bind_DemoVec2(dest);
+                bind_LazyDemo(dest);
                 return;
             }
 
@@ -589,6 +641,28 @@ namespace cvv8 {
             ctor->Set(JSTR("testLockerNoUnlocking"),
                 CastToJS(FunctionToInCa<void (), test_using_locker<false>, false>::Call)
             );
+            ctor->Set(JSTR("isV8LockedUnlocking"),
+                CastToJS(FunctionToInCa<bool (), isV8Locked, true >::Call)
+            );
+            ctor->Set(JSTR("isV8LockedNoUnlocking"),
+                CastToJS(FunctionToInCa<bool (), isV8Locked, false>::Call)
+            );
+            ctor->Set(JSTR("movePoint"),
+                CastToJS(FunctionToInCa<DemoPoint (DemoPoint, int), movePoint>::Call)
+            );
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+            ctor->Set(JSTR("divideBatch"),
+                CastToJS(FunctionToBatchInCa<int (int, int), demoDivide>::Call)
+            );
+#endif
+#if CVV8_CONFIG_HAS_STD_THREAD && CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+            ctor->Set(JSTR("divideAsync"),
+                CastToJS(FunctionToAsyncInCa<int (int, int), demoDivide>::Call)
+            );
+            ctor->Set(JSTR("runAsyncCompletions"),
+                CastToJS(runAsyncCompletions)
+            );
+#endif
 
             ////////////////////////////////////////////////////////////
             // Add class to the destination object...
@@ -606,6 +680,9 @@ namespace cvv8 {
                 CC::DestroyObject( vinst );
             }
             bind_BoundSubNative(dest);
+            bind_MIClasses(dest);
+            bind_DemoVec2(dest);
+            bind_LazyDemo(dest);
             CERR << "Finished binding BoundNative.\n";
         }
     };
@@ -657,6 +734,86 @@ v8::Handle<v8::Value> bind_BoundSubNative( v8::Handle<v8::Object> dest )
     cc.AddClassTo(cv::TypeName<BSN>::Value,dest);
     return dest;
 }
+
+/**
+   Binds MIMixin and its subclass MIDerived, whose MIMixin part is not
+   at offset 0, so that MIMixin's methods only work on MIDerived
+   objects if the upcast adjusts the pointer.
+*/
+void bind_MIClasses( v8::Handle<v8::Object> dest )
+{
+    typedef cv::ClassCreator<MIMixin> CCM;
+    typedef cv::ClassCreator<MIDerived> CCD;
+    CCM & m( CCM::Instance() );
+    if( ! m.IsSealed() )
+    {
+        m("getMixinValue",
+          cv::ConstMethodToInCa<MIMixin, int (), &MIMixin::getMixinValue>::Call)
+         ("mixinSelf",
+          cv::MethodToInCa<MIMixin, MIMixin * (), &MIMixin::mixinSelf>::Call)
+         ("destroy", CCM::DestroyObjectCallback)
+         ;
+    }
+    m.CtorFunction()->Set( JSTR("fromValue"),
+        cv::CastToJS( cv::FunctionToInCa<MIMixin (int), mixinFromValue>::Call ) );
+    m.CtorFunction()->SetAccessor( JSTR("copies"),
+        cv::VarToGetter<int, &MIMixin::copies>::Get );
+    m.AddClassTo( cv::TypeName<MIMixin>::Value, dest );
+    CCD & d( CCD::Instance() );
+    if( ! d.IsSealed() ) d.Inherit<MIMixin>();
+    d.AddClassTo( cv::TypeName<MIDerived>::Value, dest );
+}
+
+/**
+   Binds DemoVec2, which uses ClassCreator_InlineStorage.
+*/
+void bind_DemoVec2( v8::Handle<v8::Object> dest )
+{
+    typedef cv::ClassCreator<DemoVec2> CC;
+    typedef cv::MemberToAccessors<DemoVec2, double, &DemoVec2::x> X;
+    typedef cv::MemberToAccessors<DemoVec2, double, &DemoVec2::y> Y;
+    CC & cc( CC::Instance() );
+    if( ! cc.IsSealed() )
+    {
+        cc("length2",
+           cv::ConstMethodToInCa<DemoVec2, double (), &DemoVec2::length2>::Call)
+          ("destroy", CC::DestroyObjectCallback)
+          ;
+        cv::AccessorAdder acc( cc.Prototype() );
+        acc("x", X(), X() )
+           ("y", Y(), Y() );
+    }
+    cc.AddClassTo( cv::TypeName<DemoVec2>::Value, dest );
+}
+
+/** Number of times setupLazyDemo() has run. */
+int lazyDemoSetups = 0;
+
+/**
+   LazyBinding setup function for the LazyDemo object: binds DemoVec2
+   into target and sets its "sibling" property.
+*/
+void setupLazyDemo( v8::Handle<v8::Object> const & target )
+{
+    ++lazyDemoSetups;
+    bind_DemoVec2( target );
+    target->Set( JSTR("sibling"), JSTR("set by setup") );
+}
+
+/**
+   Installs a LazyDemo object in dest, whose DemoVec2 and sibling
+   properties are set up by setupLazyDemo() on first use, and whose
+   setupCount property reports how often that has happened.
+*/
+void bind_LazyDemo( v8::Handle<v8::Object> dest )
+{
+    typedef cv::LazyBinding< void (v8::Handle<v8::Object> const &), setupLazyDemo > LB;
+    v8::Handle<v8::Object> lazy( v8::Object::New() );
+    LB::Add( lazy, "DemoVec2" );
+    LB::Add( lazy, "sibling" );
+    lazy->SetAccessor( JSTR("setupCount"), cv::VarToGetter<int, &lazyDemoSetups>::Get );
+    dest->Set( JSTR("LazyDemo"), lazy );
+}
 #undef JSTR
 
 
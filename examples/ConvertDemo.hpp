@@ -285,6 +285,83 @@ struct BoundSubNative : public BoundNative
 };
 
 
+/**
+   MIMixin and MIDerived test upcasts through ClassHierarchy to a base
+   class which does not start at the beginning of its subclass: the
+   (polymorphic) MIPad base comes first in MIDerived, so the MIMixin
+   part is at a non-zero offset.
+*/
+struct MIMixin
+{
+    int mixinValue;
+    /**
+       Number of copy constructions, so that test.js can check that
+       returning a MIMixin by value (see mixinFromValue()) moves it
+       into its JS object instead of copying it.
+    */
+    static int copies;
+    MIMixin() : mixinValue(17) {}
+    MIMixin( MIMixin const & other ) : mixinValue(other.mixinValue) { ++copies; }
+    MIMixin( MIMixin && other ) : mixinValue(other.mixinValue) {}
+    MIMixin & operator=( MIMixin const & ) = default;
+    virtual ~MIMixin() {}
+    int getMixinValue() const { return mixinValue; }
+    MIMixin * mixinSelf() { return this; }
+};
+
+/** Padding base class for MIDerived. */
+struct MIPad
+{
+    double pad[4];
+    MIPad() { pad[0] = pad[1] = pad[2] = pad[3] = -1.0; }
+    virtual ~MIPad() {}
+};
+
+/** Bound as a subclass of MIMixin, which is its second base. */
+struct MIDerived : MIPad, MIMixin
+{
+    MIDerived() { mixinValue = 23; }
+};
+
+/**
+   A small value type which ClassCreator stores by value, in a slab of
+   its own, via ClassCreator_InlineStorage.
+*/
+struct DemoVec2
+{
+    double x;
+    double y;
+    DemoVec2() : x(0), y(0) {}
+    DemoVec2( double x_, double y_ ) : x(x_), y(y_) {}
+    double length2() const { return x*x + y*y; }
+};
+
+// DemoVec2 ctors, used for constructing it in its inline storage slot:
+typedef cv::Signature<DemoVec2 (
+    cv::CtorForwarder<DemoVec2 *()>,
+    cv::CtorForwarder<DemoVec2 *(double, double)>
+)> DemoVec2Ctors;
+
+/** Returns a MIMixin with the given mixinValue, by value. */
+MIMixin mixinFromValue( int v );
+
+/** Returns a / b, throwing a std::runtime_error if b is 0. */
+int demoDivide( int a, int b );
+
+/**
+   A plain struct converted to and from plain JS objects via
+   StructDescriptor (see BoundNative.movePoint() in the demo code).
+*/
+struct DemoPoint
+{
+    int x;
+    int y;
+    std::string label;
+};
+
+/** Returns p moved by (dx,dx), with label "moved(LABEL)". */
+DemoPoint movePoint( DemoPoint p, int dx );
+
 /**
    The following code is mostly here for use with ClassCreator<>, a
    class-binding mechanism which is demonstrated in
@@ -400,6 +477,14 @@ namespace cvv8 {
     struct ClassCreator_SearchPrototypeForThis<BoundSubNative> : ClassCreator_SearchPrototypeForThis<BoundNative>
     {};
 
+    /**
+       Optional: gives the BoundNative constructor a createMany()
+       function, which creates several instances with one call.
+    */
+    template <>
+    struct ClassCreator_CreateMany<BoundNative> : Opt_Bool<true>
+    {};
+
     /**
        Optional: enable function calls to BoundNative() to work like a
        constructor call. Without this, calling BoundNative() without
@@ -468,4 +553,66 @@ namespace cvv8 {
         :  NativeToJSMap<BoundSubNative>::NativeToJSImpl
     {};
 
+    /**
+       MIMixin and MIDerived use the default internal field layout
+       (which stores the type ID, so that MIMixin bindings can
+       recognize and upcast MIDerived objects) and map natives to
+       their JS objects via NativeToJSMap.
+    */
+    template <>
+    struct StructDescriptor<DemoPoint>
+    {
+        typedef CVV8_TYPELIST((
+            StructField<DemoPoint, int, &DemoPoint::x>,
+            StructField<DemoPoint, int, &DemoPoint::y>,
+            StructField<DemoPoint, std::string, &DemoPoint::label>
+        )) Fields;
+        static char const * const (&FieldNames())[3]
+        {
+            static char const * const names[] = { "x", "y", "label" };
+            return names;
+        }
+    };
+    template <>
+    struct NativeToJS<DemoPoint> : NativeToJS_Struct<DemoPoint>
+    {};
+    template <>
+    struct JSToNative<DemoPoint> : JSToNative_Struct<DemoPoint>
+    {};
+
+    CVV8_TypeName_DECL((MIMixin));
+    CVV8_TypeName_DECL((MIDerived));
+    template <>
+    class ClassCreator_Factory<MIMixin>
+        : public ClassCreator_Factory_NativeToJSMap< MIMixin, CtorForwarder<MIMixin * ()> >
+    {};
+    template <>
+    class ClassCreator_Factory<MIDerived>
+        : public ClassCreator_Factory_NativeToJSMap< MIDerived, CtorForwarder<MIDerived * ()> >
+    {};
+    template <>
+    struct JSToNative<MIMixin> : JSToNative_ClassCreator<MIMixin>
+    {};
+    template <>
+    struct JSToNative<MIDerived> : JSToNative_ClassCreator<MIDerived>
+    {};
+    template <>
+    struct NativeToJS<MIMixin> : NativeToJSMap<MIMixin>::NativeToJSImpl
+    {};
+    template <>
+    struct NativeToJS<MIDerived> : NativeToJSMap<MIDerived>::NativeToJSImpl
+    {};
+
+    CVV8_TypeName_DECL((DemoVec2));
+    /**
+       Stores DemoVec2 objects by value in ClassCreator's slab for
+       them, in place of a ClassCreator_Factory.
+    */
+    template <>
+    struct ClassCreator_InlineStorage<DemoVec2>
+        : ClassCreator_InlineStorage_Enabled< DemoVec2, CtorArityDispatcher<DemoVec2Ctors> >
+    {};
+    template <>
+    struct JSToNative<DemoVec2> : JSToNative_ClassCreator<DemoVec2>
+    {};
 }
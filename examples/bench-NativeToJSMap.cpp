@@ -0,0 +1,114 @@
+/**
+   Microbenchmark comparing the two NativeToJSMap storage backends:
+   std::map (the default) and Detail::PtrHashMap (enabled per type via
+   NativeToJSMap_UseHashTable<T>).
+
+   It does not require v8: the value type has the same layout as the
+   (NativeHandle, v8::Persistent<v8::Object>) pairs which NativeToJSMap
+   stores, i.e. two pointers.
+
+   Usage: ./bench-NativeToJSMap [lookupCount]
+*/
+#include <cvv8/detail/ptr_hash_map.hpp>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+
+namespace {
+    struct Bound { double payload[3]; };
+    typedef std::pair<void const *, void *> BindT;
+    typedef std::chrono::high_resolution_clock Clock;
+
+    double nsPerOp( Clock::time_point const & start, std::size_t ops )
+    {
+        typedef std::chrono::duration<double, std::nano> NS;
+        return std::chrono::duration_cast<NS>( Clock::now() - start ).count() / ops;
+    }
+
+    /** Prevents the optimizer from discarding lookup results. */
+    std::size_t sink = 0;
+
+    /** Adapts std::map to the PtrHashMap interface used below. */
+    struct TreeMap
+    {
+        typedef std::map<void const *, BindT> MapT;
+        MapT map;
+        void Reserve( std::size_t ) {}
+        void Insert( void const * k, BindT const & v ) { map[k] = v; }
+        BindT const * Find( void const * k ) const
+        {
+            MapT::const_iterator it = map.find(k);
+            return (map.end() == it) ? 0 : &it->second;
+        }
+        void Erase( void const * k ) { map.erase(k); }
+    };
+
+    struct HashMap : cvv8::Detail::PtrHashMap<BindT>
+    {
+        void Erase( void const * k ) { this->cvv8::Detail::PtrHashMap<BindT>::Erase(k); }
+    };
+
+    template <typename MapT>
+    void run( char const * label, std::vector<Bound*> const & objs,
+              std::vector<Bound*> const & probes, bool reserve )
+    {
+        std::size_t const n = objs.size();
+        MapT m;
+        Clock::time_point t = Clock::now();
+        if( reserve ) m.Reserve( n );
+        for( std::size_t i = 0; i < n; ++i )
+        {
+            m.Insert( objs[i], BindT( objs[i], objs[i] ) );
+        }
+        double const tIns = nsPerOp( t, n );
+
+        t = Clock::now();
+        for( std::size_t i = 0; i < probes.size(); ++i )
+        {
+            BindT const * b = m.Find( probes[i] );
+            if( b ) sink += reinterpret_cast<std::size_t>(b->second);
+        }
+        double const tFind = nsPerOp( t, probes.size() );
+
+        // Churn: unbind/rebind half of the objects, as happens when
+        // short-lived wrappers are garbage-collected and recreated.
+        t = Clock::now();
+        for( std::size_t i = 0; i < n; i += 2 ) m.Erase( objs[i] );
+        for( std::size_t i = 0; i < n; i += 2 ) m.Insert( objs[i], BindT( objs[i], objs[i] ) );
+        double const tChurn = nsPerOp( t, n );
+
+        std::cout << "  " << std::left << std::setw(22) << label << std::right
+                  << std::fixed << std::setprecision(1)
+                  << " insert " << std::setw(7) << tIns << " ns"
+                  << "  lookup " << std::setw(7) << tFind << " ns"
+                  << "  churn " << std::setw(7) << tChurn << " ns\n";
+    }
+}
+
+int main( int argc, char const * const * argv )
+{
+    std::size_t const lookups = (argc > 1) ? std::strtoul( argv[1], 0, 10 ) : 2000000;
+    std::size_t const sizes[] = { 1000, 100000, 1000000 };
+    std::srand( 42 );
+    for( unsigned s = 0; s < sizeof(sizes)/sizeof(sizes[0]); ++s )
+    {
+        std::size_t const n = sizes[s];
+        std::vector<Bound*> objs( n );
+        for( std::size_t i = 0; i < n; ++i ) objs[i] = new Bound;
+        std::vector<Bound*> probes( lookups );
+        for( std::size_t i = 0; i < lookups; ++i )
+        {
+            probes[i] = objs[ (static_cast<std::size_t>(std::rand()) * RAND_MAX + std::rand()) % n ];
+        }
+        std::cout << n << " live objects, " << lookups << " random lookups (ns/op):\n";
+        run<TreeMap>( "std::map", objs, probes, false );
+        run<HashMap>( "PtrHashMap", objs, probes, false );
+        run<HashMap>( "PtrHashMap+Reserve()", objs, probes, true );
+        for( std::size_t i = 0; i < n; ++i ) delete objs[i];
+    }
+    return (sink == 42) ? 1 : 0;
+}
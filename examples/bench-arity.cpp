@@ -0,0 +1,87 @@
+/**
+   Benchmark for arity-based overload dispatching: ArityDispatchList,
+   which looks the target up in a compile-time table indexed by the
+   argument count, compared to Detail::ArityDispatchChain, the linear
+   search ArityDispatchList used before.
+
+   The dispatchers are called in a tight loop from inside a native
+   callback (so that a real v8::Arguments object is available), which
+   keeps the JS call overhead out of the measurements.
+
+   Usage: ./bench-arity [rounds]
+*/
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+
+#include "cvv8/v8-convert.hpp"
+#include "cvv8/V8Shell.hpp"
+
+namespace {
+    typedef std::chrono::high_resolution_clock Clock;
+    namespace cv = cvv8;
+
+    int sink = 0;
+    unsigned rounds = 0;
+
+    void f0() { ++sink; }
+    void f1( int a ) { sink += a; }
+    void f2( int a, int b ) { sink += a + b; }
+    void f3( int a, int b, int c ) { sink += a + b + c; }
+    void f4( int a, int, int, int d ) { sink += a + d; }
+    void f5( int a, int, int, int, int e ) { sink += a + e; }
+    void f6( int a, int, int, int, int, int f ) { sink += a + f; }
+    void f7( int a, int, int, int, int, int, int g ) { sink += a + g; }
+
+    typedef CVV8_TYPELIST((
+        cv::FunctionToInCa<void (), f0>,
+        cv::FunctionToInCa<void (int), f1>,
+        cv::FunctionToInCa<void (int,int), f2>,
+        cv::FunctionToInCa<void (int,int,int), f3>,
+        cv::FunctionToInCa<void (int,int,int,int), f4>,
+        cv::FunctionToInCa<void (int,int,int,int,int), f5>,
+        cv::FunctionToInCa<void (int,int,int,int,int,int), f6>,
+        cv::FunctionToInCa<void (int,int,int,int,int,int,int), f7>
+    )) Overloads;
+
+    /**
+       InvocationCallback which calls InCaT::Call(argv) 'rounds' times
+       and returns the average time per call, in nanoseconds.
+    */
+    template <typename InCaT>
+    v8::Handle<v8::Value> loop( v8::Arguments const & argv )
+    {
+        Clock::time_point const start = Clock::now();
+        for( unsigned r = 0; r < rounds; ++r )
+        {
+            InCaT::Call( argv );
+        }
+        typedef std::chrono::duration<double, std::nano> NS;
+        return v8::Number::New( std::chrono::duration_cast<NS>( Clock::now() - start ).count() / rounds );
+    }
+}
+
+int main( int argc, char const * const * argv )
+{
+    rounds = (argc > 1) ? std::strtoul( argv[1], 0, 10 ) : 2000000;
+    cv::Shell shell;
+    v8::HandleScope hsc;
+    shell( "chain", loop< cv::Detail::ArityDispatchChain<Overloads> > )
+        ( "table", loop< cv::ArityDispatchList<Overloads> > );
+    char const * calls[] = {
+        "()", "(1,2,3)", "(1,2,3,4,5,6,7)"
+    };
+    std::cout << "8 overloads, " << rounds << " rounds (ns/call):\n";
+    for( unsigned i = 0; i < sizeof(calls)/sizeof(calls[0]); ++i )
+    {
+        std::string const c( calls[i] );
+        double const tChain = cv::CastFromJS<double>( shell.ExecuteString( "chain" + c ) );
+        double const tTable = cv::CastFromJS<double>( shell.ExecuteString( "table" + c ) );
+        std::cout << "  " << std::left << std::setw(18) << c << std::right
+                  << std::fixed << std::setprecision(2)
+                  << " chain " << std::setw(7) << tChain
+                  << "  table " << std::setw(7) << tTable << '\n';
+    }
+    return (sink == 42) ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/**
+   Benchmark for converting JS objects to native maps with
+   JSToNative_map, compared to the hand-written loop which was
+   needed before it existed (GetPropertyNames() plus a
+   HasRealNamedProperty() check per key).
+
+   Usage: ./bench-map [keyCount [rounds]]
+*/
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <sstream>
+#include <chrono>
+
+#include "cvv8/v8-convert.hpp"
+#include "cvv8/V8Shell.hpp"
+
+namespace {
+    typedef std::chrono::high_resolution_clock Clock;
+    typedef std::map<std::string,std::string> MapT;
+#if CVV8_CONFIG_HAS_UNORDERED_MAP
+    typedef std::unordered_map<std::string,std::string> UMapT;
+#endif
+    typedef std::vector< std::pair<std::string,std::string> > FlatMapT;
+
+    double usSince( Clock::time_point const & start, unsigned rounds )
+    {
+        typedef std::chrono::duration<double, std::micro> US;
+        return std::chrono::duration_cast<US>( Clock::now() - start ).count() / rounds;
+    }
+
+    MapT legacyFromJS( v8::Handle<v8::Value> const & jv )
+    {
+        MapT map;
+        v8::Local<v8::Object> obj( v8::Object::Cast(*jv) );
+        v8::Local<v8::Array> ar( obj->GetPropertyNames() );
+        for( uint32_t ndx = 0; ar->Has(ndx); ++ndx )
+        {
+            v8::Local<v8::Value> const k = ar->Get(v8::Integer::New(ndx));
+            if( ! obj->HasRealNamedProperty(k->ToString()) ) continue;
+            map[cvv8::CastFromJS<std::string>(k)] = cvv8::CastFromJS<std::string>(obj->Get(k));
+        }
+        return map;
+    }
+
+    std::size_t sink = 0;
+
+    void report( char const * label, double us )
+    {
+        std::cout << "  " << std::left << std::setw(36) << label << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(10) << us << " us\n";
+    }
+}
+
+int main( int argc, char const * const * argv )
+{
+    std::size_t const n = (argc > 1) ? std::strtoul( argv[1], 0, 10 ) : 3000;
+    unsigned const rounds = (argc > 2) ? std::strtoul( argv[2], 0, 10 ) : 100;
+    cvv8::Shell shell;
+    v8::HandleScope outer;
+    MapT src;
+    for( std::size_t i = 0; i < n; ++i )
+    {
+        std::ostringstream k, v;
+        k << "config.key." << i;
+        v << "value #" << i;
+        src[k.str()] = v.str();
+    }
+    v8::Handle<v8::Value> const obj( cvv8::CastToJS( src ) );
+    std::cout << n << " string properties, " << rounds << " rounds (us/round):\n";
+    Clock::time_point t;
+
+#define BENCH(LABEL,EXPR) \
+    t = Clock::now(); \
+    for( unsigned r = 0; r < rounds; ++r ) { v8::HandleScope hs; EXPR; } \
+    report( LABEL, usSince( t, rounds ) )
+
+    BENCH( "JS->std::map (legacy loop)", sink += legacyFromJS( obj ).size() );
+    BENCH( "JS->std::map (CastFromJS)", sink += cvv8::CastFromJS<MapT>( obj ).size() );
+#if CVV8_CONFIG_HAS_UNORDERED_MAP
+    BENCH( "JS->std::unordered_map (CastFromJS)", sink += cvv8::CastFromJS<UMapT>( obj ).size() );
+#endif
+    BENCH( "JS->flat map (CastFromJS)", sink += cvv8::CastFromJS<FlatMapT>( obj ).size() );
+    BENCH( "std::map->JS (CastToJS)", cvv8::CastToJS( src ) );
+#if CVV8_CONFIG_HAS_UNORDERED_MAP
+    UMapT const usrc( src.begin(), src.end() );
+    BENCH( "std::unordered_map->JS (CastToJS)", cvv8::CastToJS( usrc ) );
+#endif
+#undef BENCH
+    return (sink == 42) ? 1 : 0;
+}
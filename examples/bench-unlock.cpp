@@ -0,0 +1,121 @@
+/**
+   Benchmark for the UnlockV8 policies under multithreaded load:
+   bindings which never unlock v8, bindings which unlock around every
+   call (UnlockV8=true) and InCaAdaptiveUnlock bindings, with 1, 4 and
+   8 threads sharing one v8 instance through v8::Locker.
+
+   Each thread runs a JS loop which calls one binding 'calls' times.
+   Two natives are used: a trivial one, for which unlocking is pure
+   overhead, and one which busy-waits for about 50us, for which
+   unlocking lets the other threads run JS in the meantime.
+
+   The results are total throughput, in calls per millisecond, over
+   all threads.
+
+   Usage: ./bench-unlock [calls]
+*/
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cvv8/v8-convert.hpp"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    namespace cv = cvv8;
+
+    int quick( int a )
+    {
+        return a + 1;
+    }
+
+    int slow( int a )
+    {
+        Clock::time_point const end = Clock::now() + std::chrono::microseconds(50);
+        while( Clock::now() < end ) {}
+        return a + 1;
+    }
+
+    template <int (*Func)(int), bool UnlockV8>
+    struct Binding : cv::FunctionToInCa< int (int), Func, UnlockV8 >
+    {};
+
+    v8::Persistent<v8::Context> context;
+
+    void worker( std::string const & script )
+    {
+        v8::Locker const lock;
+        v8::HandleScope hsc;
+        v8::Context::Scope const cxs( context );
+        v8::Script::Compile( v8::String::New( script.c_str(), static_cast<int>(script.size()) ),
+                             v8::String::New( "bench-unlock" ) )->Run();
+    }
+
+    /**
+       Runs func(0..calls-1) from the given number of threads and
+       returns the throughput in calls/ms.
+    */
+    double run( char const * func, unsigned threads, unsigned calls )
+    {
+        std::string const script( std::string("for( var i = 0; i < ")
+                                  + std::to_string(calls) + "; ++i ) "
+                                  + func + "(i);" );
+        Clock::time_point const start = Clock::now();
+        std::vector<std::thread> pool;
+        for( unsigned i = 0; i < threads; ++i ) pool.push_back( std::thread( worker, script ) );
+        for( unsigned i = 0; i < threads; ++i ) pool[i].join();
+        typedef std::chrono::duration<double, std::milli> MS;
+        return (double(threads) * calls) / std::chrono::duration_cast<MS>( Clock::now() - start ).count();
+    }
+
+    template <typename InCaT>
+    void bind( v8::Handle<v8::Object> const & global, char const * name )
+    {
+        global->Set( v8::String::New( name ), v8::FunctionTemplate::New( InCaT::Call )->GetFunction() );
+    }
+}
+
+int main( int argc, char const * const * argv )
+{
+    unsigned const calls = (argc > 1) ? std::strtoul( argv[1], 0, 10 ) : 20000;
+    {
+        v8::Locker const lock;
+        v8::HandleScope hsc;
+        context = v8::Context::New();
+        v8::Context::Scope const cxs( context );
+        v8::Handle<v8::Object> global( context->Global() );
+        bind< Binding<quick, false> >( global, "quickLocked" );
+        bind< Binding<quick, true> >( global, "quickUnlock" );
+        bind< cv::InCaAdaptiveUnlock< Binding<quick, true> > >( global, "quickAdaptive" );
+        bind< Binding<slow, false> >( global, "slowLocked" );
+        bind< Binding<slow, true> >( global, "slowUnlock" );
+        bind< cv::InCaAdaptiveUnlock< Binding<slow, true> > >( global, "slowAdaptive" );
+    }
+    char const * funcs[] = {
+        "quickLocked", "quickUnlock", "quickAdaptive",
+        "slowLocked", "slowUnlock", "slowAdaptive"
+    };
+    unsigned const threadCounts[] = { 1, 4, 8 };
+    std::cout << "calls/ms, " << calls << " calls per thread:\n"
+              << std::left << std::setw(16) << "binding" << std::right;
+    for( unsigned t = 0; t < 3; ++t ) std::cout << std::setw(8) << threadCounts[t] << "T";
+    std::cout << '\n' << std::fixed << std::setprecision(1);
+    for( unsigned f = 0; f < sizeof(funcs)/sizeof(funcs[0]); ++f )
+    {
+        std::cout << std::left << std::setw(16) << funcs[f] << std::right;
+        for( unsigned t = 0; t < 3; ++t )
+        {
+            std::cout << std::setw(9) << run( funcs[f], threadCounts[t], calls ) << std::flush;
+        }
+        std::cout << '\n';
+    }
+    {
+        v8::Locker const lock;
+        context.Dispose();
+    }
+    return 0;
+}
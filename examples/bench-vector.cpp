@@ -0,0 +1,103 @@
+/**
+   Benchmark for moving numeric std::vectors across the JS/native
+   boundary:
+
+   - The element-by-element conversion used before JSToNative_list
+     and NativeToJS_list were reworked (Has()/Get(Integer::New())/
+     push_back()).
+
+   - The current Array conversions.
+
+   - NewExternalArray() and the memcpy() path of
+     JSToNative< std::vector<T> > for externally-backed objects.
+
+   Usage: ./bench-vector [elementCount [rounds]]
+*/
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+
+#include "cvv8/v8-convert.hpp"
+#include "cvv8/V8Shell.hpp"
+
+namespace {
+    typedef std::chrono::high_resolution_clock Clock;
+
+    double msSince( Clock::time_point const & start, unsigned rounds )
+    {
+        typedef std::chrono::duration<double, std::milli> MS;
+        return std::chrono::duration_cast<MS>( Clock::now() - start ).count() / rounds;
+    }
+
+    /** The pre-rework JSToNative_list algorithm. */
+    template <typename T>
+    std::vector<T> legacyFromJS( v8::Handle<v8::Value> const & jv )
+    {
+        std::vector<T> li;
+        v8::Handle<v8::Array> ar( v8::Array::Cast(*jv) );
+        for( uint32_t ndx = 0; ar->Has(ndx); ++ndx )
+        {
+            li.push_back( cvv8::CastFromJS<T>( ar->Get(v8::Integer::New(ndx)) ) );
+        }
+        return li;
+    }
+
+    /** The pre-rework NativeToJS_list algorithm. */
+    template <typename T>
+    v8::Handle<v8::Value> legacyToJS( std::vector<T> const & li )
+    {
+        v8::Handle<v8::Array> rv( v8::Array::New( static_cast<int>(li.size()) ) );
+        for( int i = 0; i < static_cast<int>(li.size()); ++i )
+        {
+            rv->Set( v8::Integer::New(i), cvv8::CastToJS( li[i] ) );
+        }
+        return rv;
+    }
+
+    std::size_t sink = 0;
+
+    void report( char const * label, double ms )
+    {
+        std::cout << "  " << std::left << std::setw(40) << label << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(10) << ms << " ms\n";
+    }
+
+    template <typename T>
+    void run( char const * typeName, std::size_t n, unsigned rounds )
+    {
+        std::vector<T> src( n );
+        for( std::size_t i = 0; i < n; ++i ) src[i] = static_cast<T>( i % 100 );
+        std::cout << "std::vector<" << typeName << ">, " << n << " elements, "
+                  << rounds << " rounds (ms/round):\n";
+
+        v8::HandleScope outer;
+        v8::Handle<v8::Value> const arr( cvv8::CastToJS( src ) );
+        v8::Handle<v8::Object> const ext( cvv8::NewExternalArray( src ) );
+        Clock::time_point t;
+
+#define BENCH(LABEL,EXPR) \
+        t = Clock::now(); \
+        for( unsigned r = 0; r < rounds; ++r ) { v8::HandleScope hs; EXPR; } \
+        report( LABEL, msSince( t, rounds ) )
+
+        BENCH( "native->Array (legacy)", legacyToJS( src ) );
+        BENCH( "native->Array (CastToJS)", cvv8::CastToJS( src ) );
+        BENCH( "native->external (NewExternalArray)", cvv8::NewExternalArray( src ) );
+        BENCH( "Array->native (legacy)", sink += legacyFromJS<T>( arr ).size() );
+        BENCH( "Array->native (CastFromJS)", sink += cvv8::CastFromJS< std::vector<T> >( arr ).size() );
+        BENCH( "external->native (CastFromJS)", sink += cvv8::CastFromJS< std::vector<T> >( ext ).size() );
+#undef BENCH
+    }
+}
+
+int main( int argc, char const * const * argv )
+{
+    std::size_t const n = (argc > 1) ? std::strtoul( argv[1], 0, 10 ) : 1000000;
+    unsigned const rounds = (argc > 2) ? std::strtoul( argv[2], 0, 10 ) : 10;
+    cvv8::Shell shell;
+    run<double>( "double", n, rounds );
+    run<int32_t>( "int32_t", n, rounds );
+    run<uint8_t>( "uint8_t", n, rounds );
+    return (sink == 42) ? 1 : 0;
+}
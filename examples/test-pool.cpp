@@ -0,0 +1,103 @@
+/**
+   Test for V8ShellPool: submits many more tasks than there are
+   workers, of both kinds (scripts and functions with JSON arguments),
+   and checks every result, including that of a task which throws and
+   of tasks run in fresh contexts.
+
+   Requires v8 3.6+ (isolate locking) and C++11 threads.
+
+   Usage: ./test-pool [workers [tasks]]
+
+   Exits with 0 on success, else prints the first mismatch and exits
+   with 1.
+*/
+#if !defined(CVV8_CONFIG_HAS_ISOLATE_LOCKING)
+#  define CVV8_CONFIG_HAS_ISOLATE_LOCKING 1
+#endif
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "cvv8/v8-convert.hpp"
+#include "cvv8/V8ShellPool.hpp"
+
+namespace {
+    namespace cv = cvv8;
+
+    int triple( int a )
+    {
+        return a * 3;
+    }
+
+    void setup( v8::Handle<v8::Object> global )
+    {
+        cv::ObjectPropSetter<v8::Object> set( global );
+        set( "triple", cv::FunctionToInCa< int (int), triple, true >::Call );
+    }
+
+    int failures = 0;
+
+    void expect( std::string const & what, std::string const & got, std::string const & want )
+    {
+        if( got == want ) return;
+        if( !failures++ )
+        {
+            std::cerr << what << ": got [" << got << "], expected [" << want << "]\n";
+        }
+    }
+}
+
+int main( int argc, char const * const * argv )
+{
+    unsigned const workers = (argc > 1) ? std::strtoul( argv[1], 0, 10 ) : 3;
+    unsigned const tasks = (argc > 2) ? std::strtoul( argv[2], 0, 10 ) : 20 * (workers ? workers : 4);
+    {
+        cv::V8ShellPool pool( setup, workers );
+        std::vector< std::future<std::string> > results;
+        for( unsigned i = 0; i < tasks; ++i )
+        {
+            std::string const n( std::to_string( i ) );
+            results.push_back( (i % 2)
+                               ? pool.Submit( "function(a,b){ var s = 0; for( var i = 0; i < 1000; ++i ) s += i % 7; return [a + b, triple(a), s]; }",
+                                              "[" + n + ", 1]" )
+                               : pool.Submit( "triple(" + n + ") + 1" ) );
+        }
+        std::future<std::string> thrown( pool.Submit( "throw new Error('expected')" ) );
+        for( unsigned i = 0; i < tasks; ++i )
+        {
+            std::string const want( (i % 2)
+                                    ? "[" + std::to_string( i + 1 ) + "," + std::to_string( i * 3 ) + ",2997]"
+                                    : std::to_string( i * 3 + 1 ) );
+            expect( "task #" + std::to_string( i ), results[i].get(), want );
+        }
+        try
+        {
+            thrown.get();
+            expect( "throwing task", "no exception", "an exception" );
+        }
+        catch( std::runtime_error const & ex )
+        {
+            expect( "throwing task", std::string( ex.what() ).find( "expected" ) != std::string::npos ? "ok" : ex.what(), "ok" );
+        }
+    }
+    {
+        cv::V8ShellPool pool( setup, workers, true );
+        std::vector< std::future<std::string> > results;
+        for( unsigned i = 0; i < tasks; ++i )
+        {
+            results.push_back( pool.Submit( "var g = (typeof g === 'undefined') ? 1 : g + 1; g" ) );
+        }
+        for( unsigned i = 0; i < tasks; ++i )
+        {
+            expect( "fresh context task #" + std::to_string( i ), results[i].get(), "1" );
+        }
+    }
+    if( failures )
+    {
+        std::cerr << failures << " failure(s).\n";
+        return 1;
+    }
+    std::cout << "V8ShellPool: " << tasks << " tasks on " << workers << " workers OK.\n";
+    return 0;
+}
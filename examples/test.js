@@ -144,6 +144,256 @@ function test3()
 
 }
 
+function testPrototypeHolderCache()
+{
+    print("Testing native lookups through changed JS prototype chains...");
+    var a = new BoundNative(1), b = new BoundNative(2);
+    function Mid() {}
+    function MySub() {}
+    Mid.prototype = a;
+    MySub.prototype = new Mid();
+    var m = new MySub();
+    asserteq( 1, m.publicIntRO, 'native found two levels up the prototype chain' );
+    asserteq( 1, m.publicIntRO, 'native found via the cached holder' );
+    MySub.prototype.__proto__ = b;
+    asserteq( 2, m.publicIntRO, 'lookup follows a __proto__ change' );
+    MySub.prototype.__proto__ = {};
+    assertThrows( function(){ BoundNative.prototype.doFoo.call(m); }, 'no native left in the prototype chain' );
+    MySub.prototype.__proto__ = a;
+    asserteq( 1, m.publicIntRO, 'holder a is found and cached again' );
+    var c = new BoundNative(3);
+    c.__proto__ = a;
+    MySub.prototype.__proto__ = c;
+    asserteq( 3, m.publicIntRO, 'a nearer holder inserted before the cached one wins' );
+    a.destroy();
+    b.destroy();
+    c.destroy();
+}
+
+function testCtorWithoutNew()
+{
+    print("Testing bound constructors called without 'new'...");
+    var b = BoundNative(7);
+    assert( b instanceof BoundNative, 'BoundNative(7) is-a BoundNative' );
+    asserteq( 7, b.publicIntRO, 'the native was constructed from the arguments' );
+    b.doFoo();
+    var d = BoundNative(42);
+    asserteq( 42, d.publicIntRO, 'BoundNative(42).publicIntRO' );
+    assert( b !== d, 'each call creates a new object' );
+    var s = BoundSubNative();
+    assert( s instanceof BoundSubNative, 'BoundSubNative() is-a BoundSubNative' );
+    assert( s instanceof BoundNative, 'BoundSubNative() is-a BoundNative' );
+    asserteq( BoundSubNative.prototype, s.__proto__, 'BoundSubNative() gets the subclass prototype' );
+    s.subFunc();
+    assert( b.destroy(), 'b.destroy()' );
+    assert( d.destroy(), 'd.destroy()' );
+}
+
+function testCreateMany()
+{
+    if( 'function' !== typeof BoundNative.createMany ) {
+        print("BoundNative.createMany() is not bound - skipping test.");
+        return;
+    }
+    print("Testing ClassCreator createMany()...");
+    var li = BoundNative.createMany( 4, 9 );
+    asserteq( 4, li.length, 'createMany(4,9).length' );
+    var i, k;
+    for( i = 0; i < li.length; ++i ) {
+        assert( li[i] instanceof BoundNative, 'entry #'+i+' is-a BoundNative' );
+        asserteq( 9, li[i].publicIntRO, 'entry #'+i+' was constructed with the given arguments' );
+        for( k = 0; k < i; ++k ) assert( li[i] !== li[k], 'entries #'+k+' and #'+i+' are distinct' );
+    }
+    li[0].publicIntRW = 3;
+    asserteq( 9, li[1].publicIntRO, 'entries have distinct natives' );
+    li = BoundNative.createMany( 2 );
+    asserteq( 42, li[1].publicIntRO, 'createMany(2) uses the default constructor' );
+    asserteq( 0, BoundNative.createMany( 0 ).length, 'createMany(0)' );
+    assertThrows( function(){ BoundNative.createMany( -1 ); }, 'negative count' );
+}
+
+function testClassStats()
+{
+    if( 'function' !== typeof this.classStats ) {
+        print("classStats() is not available - skipping test.");
+        return;
+    }
+    print("Testing ClassCreator instance statistics...");
+    function bnStats() {
+        var st = classStats()['BoundNative'];
+        assert( st, 'BoundNative is registered' );
+        return st;
+    }
+    var before = bnStats();
+    var b = new BoundNative();
+    var mid = bnStats();
+    asserteq( before.created + 1, mid.created, 'created' );
+    asserteq( before.live + 1, mid.live, 'live' );
+    assert( b.destroy(), 'b.destroy()' );
+    var after = bnStats();
+    asserteq( mid.live - 1, after.live, 'live after destroy()' );
+    asserteq( mid.destroyedExplicitly + 1, after.destroyedExplicitly, 'destroyedExplicitly' );
+    asserteq( mid.destroyed + 1, after.destroyed, 'destroyed' );
+    assert( /BoundNative/.test( classStatsText() ), 'classStatsText() lists BoundNative' );
+}
+
+function testMultipleInheritance()
+{
+    if( !('MIDerived' in this) ) {
+        print("MIDerived is not bound - skipping test.");
+        return;
+    }
+    print("Testing upcasts to a base class at a non-zero offset...");
+    var m = new MIMixin(), d = new MIDerived();
+    assert( d instanceof MIMixin, 'd is-a MIMixin' );
+    asserteq( 17, m.getMixinValue(), 'm.getMixinValue()' );
+    asserteq( 23, d.getMixinValue(), 'MIMixin method called on a MIDerived' );
+    asserteq( m, m.mixinSelf(), 'm.mixinSelf()' );
+    asserteq( d, d.mixinSelf(), 'CastToJS<MIMixin>() on a MIDerived finds its JS object' );
+    assert( d.destroy(), 'd.destroy()' );
+    assertThrows( function(){ d.getMixinValue(); } );
+    assert( m.destroy(), 'm.destroy()' );
+}
+
+function testReturnByValue()
+{
+    if( !('MIMixin' in this) ) {
+        print("MIMixin is not bound - skipping test.");
+        return;
+    }
+    print("Testing natives returned by value...");
+    var copies = MIMixin.copies;
+    var m = MIMixin.fromValue( 5 );
+    assert( m instanceof MIMixin, 'returned value is wrapped as a MIMixin' );
+    asserteq( 5, m.getMixinValue(), 'm.getMixinValue()' );
+    asserteq( m, m.mixinSelf(), 'the returned object is mapped to its native' );
+    asserteq( copies, MIMixin.copies, 'the returned value was moved, not copied' );
+    assert( m.destroy(), 'm.destroy()' );
+}
+
+function testBatchCalls()
+{
+    if( !('divideBatch' in BoundNative) ) {
+        print("BoundNative.divideBatch() is not bound - skipping test.");
+        return;
+    }
+    print("Testing batch calls...");
+    var rv = BoundNative.divideBatch( [[6,3], [8,2], [9,3]] );
+    asserteq( '2,4,3', rv.join(), 'array-of-tuples form' );
+    rv = BoundNative.divideBatch( [6,8,9], [3,2,3] );
+    asserteq( '2,4,3', rv.join(), 'parallel arrays form' );
+    asserteq( 0, BoundNative.divideBatch( [] ).length, 'empty batch' );
+    assertThrows( function(){ BoundNative.divideBatch( [[6,3], [1,0]] ); }, 'a throwing entry fails the batch' );
+    assertThrows( function(){ BoundNative.divideBatch( [[6,3], [1]] ); }, 'tuple of the wrong length' );
+    assertThrows( function(){ BoundNative.divideBatch( [6,8], [3] ); }, 'parallel arrays of different lengths' );
+    assertThrows( function(){ BoundNative.divideBatch( 6, 3 ); }, 'non-array arguments' );
+}
+
+function testAsyncCalls()
+{
+    if( !('divideAsync' in BoundNative) ) {
+        print("BoundNative.divideAsync() is not bound - skipping test.");
+        return;
+    }
+    print("Testing asynchronous calls...");
+    var results = {};
+    function callback(name) {
+        return function(err, rv) { results[name] = { self: this, err: err, rv: rv }; };
+    }
+    asserteq( undefined, BoundNative.divideAsync( 6, 3, callback('ok') ), 'async call returns undefined' );
+    BoundNative.divideAsync( 1, 0, callback('error') );
+    var holder = { divideAsync: BoundNative.divideAsync };
+    holder.divideAsync( 8, 2, callback('holder') );
+    assertThrows( function(){ BoundNative.divideAsync( 6, 3 ); }, 'missing callback' );
+    assert( !('ok' in results), 'callbacks do not run before completions are delivered' );
+    BoundNative.runAsyncCompletions();
+    asserteq( null, results.ok.err, 'no error' );
+    asserteq( 2, results.ok.rv, '6 / 3' );
+    assert( results.ok.self === BoundNative, 'callback is called on the original this' );
+    assert( results.error.err instanceof Error, 'native exception becomes an Error' );
+    assert( /division by zero/.test( results.error.err.message ), 'error message: '+results.error.err.message );
+    asserteq( undefined, results.error.rv, 'no result on error' );
+    asserteq( 4, results.holder.rv, '8 / 2' );
+    assert( results.holder.self === holder, 'callback is called on the holder object' );
+}
+
+function testInlineStorage()
+{
+    if( !('DemoVec2' in this) ) {
+        print("DemoVec2 is not bound - skipping test.");
+        return;
+    }
+    print("Testing ClassCreator_InlineStorage via DemoVec2...");
+    var v = new DemoVec2( 3, 4 );
+    assert( v instanceof DemoVec2, 'v is-a DemoVec2' );
+    asserteq( 3, v.x, 'v.x' );
+    asserteq( 4, v.y, 'v.y' );
+    asserteq( 25, v.length2(), 'v.length2()' );
+    v.x = 6;
+    v.y = 8;
+    asserteq( 100, v.length2(), 'setters write to the stored value' );
+    var w = new DemoVec2();
+    asserteq( 0, w.length2(), 'default-constructed DemoVec2' );
+    asserteq( 6, v.x, 'objects have separate slots' );
+    assert( v.destroy(), 'v.destroy()' );
+    assertThrows( function(){ v.length2(); }, 'destroyed object has no native' );
+    var u = new DemoVec2( 1, 2 );
+    asserteq( 5, u.length2(), 'new object, possibly in the freed slot' );
+    asserteq( 0, w.length2(), 'other objects are unaffected by slot reuse' );
+    assert( u.destroy(), 'u.destroy()' );
+    assert( w.destroy(), 'w.destroy()' );
+}
+
+function testLazyBinding()
+{
+    if( !('LazyDemo' in this) ) {
+        print("LazyDemo is not bound - skipping test.");
+        return;
+    }
+    print("Testing LazyBinding...");
+    var count = LazyDemo.setupCount;
+    LazyDemo.sibling = 'assigned';
+    asserteq( count, LazyDemo.setupCount, 'assigning a lazy property does not run setup' );
+    asserteq( 'assigned', LazyDemo.sibling, 'assignment replaced the sibling accessor' );
+    var ctor = LazyDemo.DemoVec2;
+    asserteq( count + 1, LazyDemo.setupCount, 'first read runs setup' );
+    assert( ctor === DemoVec2, 'the property holds the real constructor' );
+    assert( LazyDemo.DemoVec2 === ctor, 'later reads get the same constructor' );
+    asserteq( 'set by setup', LazyDemo.sibling, 'setup replaced the sibling' );
+    asserteq( count + 1, LazyDemo.setupCount, 'setup ran only once' );
+    var v = new ctor( 1, 2 );
+    asserteq( 5, v.length2(), 'lazily bound constructor works' );
+    assert( v.destroy(), 'v.destroy()' );
+}
+
+function testStructRoundTrip()
+{
+    print("Testing struct conversions via StructDescriptor...");
+    var p = BoundNative.movePoint( {x:1, y:2, label:'p'}, 10 );
+    asserteq( 11, p.x, 'p.x' );
+    asserteq( 12, p.y, 'p.y' );
+    asserteq( 'moved(p)', p.label, 'p.label' );
+    var q = BoundNative.movePoint( p, -11 );
+    asserteq( 0, q.x, 'q.x' );
+    asserteq( 1, q.y, 'q.y' );
+    asserteq( 'moved(moved(p))', q.label, 'q.label' );
+    q = BoundNative.movePoint( null, 1 );
+    asserteq( 1, q.x, 'non-objects convert to a value-initialized struct' );
+    asserteq( 1, q.y, 'q.y' );
+    asserteq( 'moved()', q.label, 'q.label' );
+}
+
+function testUnlockedCalls()
+{
+    print("Testing that UnlockV8 bindings really unlock v8...");
+    if( ! BoundNative.isV8LockedNoUnlocking() ) {
+        print("v8::Locker is not in use - skipping test.");
+        return;
+    }
+    asserteq( false, BoundNative.isV8LockedUnlocking(), 'v8 is unlocked during an UnlockV8 call' );
+    asserteq( true, BoundNative.isV8LockedNoUnlocking(), 'v8 is locked again afterwards' );
+}
+
 function test4()
 {
     if( ! BoundNative.prototype.runGC ) {
@@ -262,6 +512,18 @@ if(0) {
 test1();
 test2();
 test3();
+testPrototypeHolderCache();
+testCtorWithoutNew();
+testCreateMany();
+testClassStats();
+testMultipleInheritance();
+testReturnByValue();
+testInlineStorage();
+testLazyBinding();
+testStructRoundTrip();
+testBatchCalls();
+testAsyncCalls();
+testUnlockedCalls();
 if( 0 && ('sleep' in BoundNative) && ('function' === typeof BoundNative.sleep) ) {
     test4();
     testUnlockedFunctions();
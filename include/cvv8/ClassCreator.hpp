@@ -63,10 +63,19 @@
 */
 
 #include <cassert>
+#include <cstddef>
 #include <stdexcept>
+#include <type_traits>
 #include "convert.hpp"
 //#include <iostream> // only for debuggering
 #include "NativeToJSMap.hpp"
+#include "detail/slab_pool.hpp"
+#include "detail/deferred_delete.hpp"
+#include "detail/external_memory.hpp"
+#include "detail/class_stats.hpp"
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+#  include <tuple>
+#endif
 namespace cvv8 {
 
     /**
@@ -118,6 +127,28 @@ namespace cvv8 {
         {
             delete obj;
         }
+
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+        /**
+           Optional: constructs a new T from the given arguments, with
+           the same ownership rules as Create(). It is used by
+           ClassCreator::NewInstanceEmplace() and NewInstanceFrom(),
+           e.g. when converting a T returned by value to JS, so that
+           the object is constructed once instead of being
+           default-constructed and then assigned to.
+
+           Factories which do not provide it still work, but not with
+           NewInstanceEmplace(), and NewInstanceFrom() then falls back
+           to Create() plus an assignment.
+
+           The default implementation returns (new T(args...)).
+        */
+        template <typename... Args>
+        static ReturnType Emplace( v8::Persistent<v8::Object> & jsSelf, Args &&... args )
+        {
+            return new T( std::forward<Args>(args)... );
+        }
+#endif
     };
 
     /**
@@ -180,6 +211,152 @@ namespace cvv8 {
     struct ClassCreator_SearchPrototypeForThis : Opt_Bool<true>
     {};
 
+    /**
+       ClassCreator policy which determines whether native objects
+       collected by the JS garbage collector are destroyed immediately,
+       from inside v8's weak-reference callback (the default), or are
+       handed to DeferredDeleteQueue to be destroyed later, outside of
+       the GC pause. Enable it, by subclassing Opt_Bool<true>, for
+       types with expensive destructors.
+
+       Deferral only affects the native destructor (Factory::Delete()):
+       the JS/native connection is still severed (and
+       ClassCreator_WeakWrap<T>::Unwrap() still called) during GC.
+       Explicit destruction via ClassCreator<T>::DestroyObject() is
+       never deferred.
+
+       Do not enable this for types whose Factory::Delete() does JS-side
+       cleanup which must happen during GC, e.g.
+       ClassCreator_Factory_NativeToJSMap (its native-to-JS mapping
+       would refer to a dead JS object until the queue is drained).
+    */
+    template <typename T>
+    struct ClassCreator_DeferredDelete : Opt_Bool<false>
+    {};
+
+    /**
+       ClassCreator policy which, if ClassCreator_DeferredDelete<T> is
+       enabled, specifies whether Factory::Delete() for T may be
+       called from a thread which does not hold the v8 lock. If true,
+       such objects may be destroyed by DeferredDeleteQueue's
+       background worker. That requires that T's destructor neither
+       touch v8 nor share unsynchronized state with the v8 thread, and
+       that the Factory's deallocation be thread-safe
+       (ClassCreator_Factory_Pooled and ClassCreator_InlineStorage,
+       for example, are not, and enabling this for them is a
+       compile-time error).
+    */
+    template <typename T>
+    struct ClassCreator_DeleteIsThreadSafe : Opt_Bool<false>
+    {};
+
+    /**
+       ClassCreator policy which, if true, gives T's JS constructor
+       function a createMany() function (see
+       ClassCreator<T>::CreateManyCallback()), for creating large
+       numbers of instances with one call. Enable it by subclassing
+       Opt_Bool<true>.
+    */
+    template <typename T>
+    struct ClassCreator_CreateMany : Opt_Bool<false>
+    {};
+
+    /**
+       ClassCreator policy for small value types (2D/3D vectors,
+       timestamps, IDs and the like) which should not cost a heap
+       allocation per JS object. If Value is true, ClassCreator stores
+       T objects by value in a slab of memory reserved for T alone,
+       constructing them in place with Ctor::CallInPlace(), and uses
+       that in place of ClassCreator_Factory<T>, which is then
+       ignored. The internal field holds the object's address in the
+       slab, so CastFromJS<T>() returns a pointer to the stored value
+       as usual, objects of the same type are packed together, and
+       destroying one (from the GC or DestroyObject()) just puts its
+       slot back on the slab's free-list.
+
+       Enable it by subclassing ClassCreator_InlineStorage_Enabled:
+
+       @code
+       namespace cvv8 {
+           template <>
+           struct ClassCreator_InlineStorage<Vec2> :
+               ClassCreator_InlineStorage_Enabled< Vec2, CtorForwarder<Vec2 *(double,double)> >
+           {};
+       }
+       @endcode
+
+       Requirements: T must be at most MaxSize bytes and, because its
+       destructor is never called, must be trivially destructible
+       (both are checked at compile time). The storage is a
+       ClassCreator_Factory_Pooled with a pool of T's own, so, like
+       that, it is not thread-safe, and subclasses of T cannot be
+       stored in it.
+    */
+    template <typename T>
+    struct ClassCreator_InlineStorage : Opt_Bool<false>
+    {};
+
+    /**
+       Base class for enabled ClassCreator_InlineStorage
+       specializations. CtorT is the constructor proxy used to
+       construct T objects in their slots. It must provide the
+       CallInPlace() interface of CtorForwarder, e.g. a CtorForwarder
+       or CtorArityDispatcher.
+    */
+    template <typename T, typename CtorT = CtorForwarder<T * ()> >
+    struct ClassCreator_InlineStorage_Enabled : Opt_Bool<true>
+    {
+        /** The constructor proxy. */
+        typedef CtorT Ctor;
+        /** The largest supported sizeof(T). */
+        static const std::size_t MaxSize = 4 * sizeof(void *);
+    };
+
+    /**
+       ClassCreator policy for reporting the native memory held by T
+       objects to v8, so that the garbage collector knows how much
+       memory it would free by collecting them (otherwise a small JS
+       object holding a large native buffer looks cheap, and the heap
+       grows far beyond what it should before a collection happens).
+
+       If Value is true, Size() is called for each object when it is
+       wrapped and the result is passed to
+       v8::V8::AdjustAmountOfExternalAllocatedMemory(), and the same
+       amount is given back when the object is unwrapped (destroyed
+       explicitly or by the GC). If an object's size changes while
+       it is wrapped, call ClassCreator<T>::ExternalMemoryResized()
+       (doing so for objects which are not wrapped is harmless).
+
+       The per-type totals can be monitored via ExternalMemory.
+
+       To enable it:
+
+       @code
+       namespace cvv8 {
+           template <>
+           struct ClassCreator_ExternalMemory<MyType> : Opt_Bool<true>
+           {
+               static std::size_t Size( MyType const & obj )
+               {
+                   return obj.bufferSize();
+               }
+           };
+       }
+       @endcode
+
+       Size() should include only memory which the object owns
+       exclusively, and need not be exact.
+    */
+    template <typename T>
+    struct ClassCreator_ExternalMemory : Opt_Bool<false>
+    {
+        /** Returns the number of native bytes held by obj. */
+        static std::size_t Size( T const & )
+        {
+            return 0;
+        }
+    };
+
     /**
         ClassCreator policy type which defines a "type ID" value
         for a type wrapped using ClassCreator. This is used
@@ -202,14 +379,17 @@ namespace cvv8 {
         to do it) or (B) write some script code to confuse two bound native
         types about who is really who when a particular member is called.
 
-        In the case of subclassed bound types, the
-        ClassCreator_TypeID<SubClass> impl should subclass
-        ClassCreator_TypeID<ParentClass>. Whether or not this is _required_
-        for proper functionality depends at least in part on whether
-        (ClassCreator_InternalFields<ParentType>::TypeIDIndex>=0). If it is
-        negative, subclasses do not need to explicitly define this policy
-        because the type ID won't be used for purposes of validating a JS-held
-        pointer's native type.
+        In the case of subclassed bound types, subclasses bound with
+        ClassCreator<SubClass>::Inherit<ParentClass>() should keep their own
+        (default) type ID: the subclass is then registered with
+        ClassHierarchy, which lets ParentClass conversions accept SubClass
+        objects and adjust the pointer as needed. The older approach, in which
+        ClassCreator_TypeID<SubClass> subclasses ClassCreator_TypeID<ParentClass>,
+        still works, but only if the ParentClass part of a SubClass object
+        starts at the same address as the object. If
+        (ClassCreator_InternalFields<ParentType>::TypeIDIndex<0) then the type
+        ID is not used for purposes of validating a JS-held pointer's native
+        type, and no adjustment is done.
 
         TODO: see if we can consolidate this type with TypeName<>. The problem
         at the moment is that JSToNative_ObjectWithInternalFieldsTypeSafe
@@ -401,6 +581,90 @@ namespace cvv8 {
         }
     };
 
+    /**
+        Defers a binding setup function until the bindings are first
+        used, so that contexts do not pay for building the function
+        templates, prototypes and accessors of classes which their
+        scripts never touch.
+
+        Sig is the signature of the setup function, e.g.
+        (void (v8::Handle<v8::Object> const &)), and Setup is the
+        function. Add() installs an accessor for a given property name
+        on the target object. The first time a script reads the
+        property, the accessor removes itself, runs Setup(target), and
+        returns whatever Setup() stored under that name. If Setup()
+        throws, the accessor is re-installed (so the next access tries
+        again) and the exception becomes a JS exception.
+
+        Setup() must define the property it was installed for. It may
+        define others as well: Add() can be called for each of them
+        with the same Setup, and assigning to any of them (which
+        Setup() does) replaces the accessor with the assigned value.
+        Setup() may hence run more than once if a script never reads
+        one of its properties, so it should follow the run-once
+        pattern described in ClassCreator_SetupBindings.
+
+        Example:
+
+        @code
+        LazyBinding< void (v8::Handle<v8::Object>), JSByteArray::SetupBindings >
+            ::Add( global, "ByteArray" );
+        // Or, for ClassCreator-bound types:
+        ClassCreator<MyType>::SetupBindingsLazily( global, "MyType" );
+        @endcode
+    */
+    template <typename Sig, typename FunctionSignature<Sig>::FunctionType Setup>
+    struct LazyBinding
+    {
+        /**
+            Installs the lazy accessor for the given property name
+            in target.
+        */
+        static void Add( v8::Handle<v8::Object> const & target, char const * name )
+        {
+            Add( target, SymbolCache::Get( name ) );
+        }
+
+        /** Overload taking the property name as a JS string. */
+        static void Add( v8::Handle<v8::Object> const & target, v8::Handle<v8::String> const & name )
+        {
+            target->SetAccessor( name, Get, Set );
+        }
+
+    private:
+        /** Runs Setup() and returns the property it defined. */
+        static v8::Handle<v8::Value> Get( v8::Local<v8::String> name, v8::AccessorInfo const & info )
+        {
+            v8::HandleScope hsc;
+            v8::Local<v8::Object> const self( info.Holder() );
+            self->Delete( name );
+            try
+            {
+                Setup( self );
+            }
+            catch( std::exception const & ex )
+            {
+                Add( self, name );
+                return Toss( CastToJS(ex) );
+            }
+            catch(...)
+            {
+                Add( self, name );
+                return Toss( "Lazy binding setup threw an unknown native exception!" );
+            }
+            return hsc.Close( self->Get( name ) );
+        }
+
+        /** Replaces the accessor with a plain property holding value. */
+        static void Set( v8::Local<v8::String> name, v8::Local<v8::Value> value,
+                         v8::AccessorInfo const & info )
+        {
+            v8::Local<v8::Object> const self( info.Holder() );
+            self->Delete( name );
+            self->Set( name, value );
+        }
+    };
+
     /**
        The ClassCreator policy class responsible for doing optional
        class-specific binding-related work as part of the JS/Native
@@ -523,6 +787,163 @@ namespace cvv8 {
         };
     }
 #endif
+    template <typename T, typename CtorT = CtorForwarder<T * ()>, typename Tag = void>
+    struct ClassCreator_Factory_Pooled;
+
+#if !defined(DOXYGEN)
+    namespace Detail
+    {
+        /**
+           The block size ClassCreator_Factory_Pooled<T,CtorT,Tag> uses
+           for Type: the shared size class of sizeof(Type) if Tag is
+           void, else (for a pool of Type's own) sizeof(Type) rounded
+           up to a multiple of Type's alignment (and to at least one
+           pointer, which the pool's free-list needs).
+        */
+        template <typename Type, typename Tag>
+        struct PooledBlockSize
+        {
+        private:
+            enum { Align = (std::alignment_of<Type>::value > std::alignment_of<void *>::value)
+                           ? std::alignment_of<Type>::value : std::alignment_of<void *>::value };
+            enum { Size = (sizeof(Type) > sizeof(void *)) ? sizeof(Type) : sizeof(void *) };
+        public:
+            enum { Value = (Size + Align - 1) / Align * Align };
+        };
+        template <typename Type>
+        struct PooledBlockSize<Type, void>
+        {
+            enum { Value = PoolSizeClass<sizeof(Type)>::Value };
+        };
+
+        /**
+           Value is true if Factory allocates from a SlabPool (i.e. is
+           or derives from a ClassCreator_Factory_Pooled), which is
+           not thread-safe.
+        */
+        template <typename Factory>
+        struct FactoryUsesPool
+        {
+        private:
+            template <typename F> static char check( typename F::Pool * );
+            template <typename F> static long check( ... );
+        public:
+            enum { Value = (1 == sizeof(check<Factory>(0))) };
+        };
+
+        /**
+           Calls Factory::Reserve(n) if Factory has a static
+           (void (std::size_t)) Reserve() function, else does nothing.
+        */
+        template <typename Factory>
+        struct FactoryReserve
+        {
+        private:
+            template <typename U, void (*)(std::size_t)> struct Sig {};
+            template <typename U> static char check( Sig<U, &U::Reserve> * );
+            template <typename U> static long check( ... );
+            static void call( std::size_t n, tmp::BoolVal<true> ) { Factory::Reserve( n ); }
+            static void call( std::size_t, tmp::BoolVal<false> ) {}
+        public:
+            enum { Value = (1 == sizeof(check<Factory>(0))) };
+            static void Reserve( std::size_t n )
+            {
+                call( n, tmp::BoolVal<Value>() );
+            }
+        };
+
+        /** The ClassCreator_Factory_Pooled tag of T's inline storage. */
+        template <typename T>
+        struct InlineStorageTag {};
+
+        /**
+           The factory ClassCreator uses for T when
+           ClassCreator_InlineStorage<T> is enabled: a
+           ClassCreator_Factory_Pooled with a slab of T-sized slots
+           which no other type shares.
+        */
+        template <typename T>
+        struct Factory_InlineStorage
+            : ClassCreator_Factory_Pooled< T, typename ClassCreator_InlineStorage<T>::Ctor, InlineStorageTag<T> >
+        {
+        private:
+            typedef ClassCreator_InlineStorage<T> Policy;
+            typedef typename TypeInfo<T>::Type Type;
+            static_assert( sizeof(Type) <= Policy::MaxSize,
+                           "ClassCreator_InlineStorage<T>: T is larger than MaxSize." );
+            static_assert( std::is_trivially_destructible<Type>::value,
+                           "ClassCreator_InlineStorage requires a trivially destructible type." );
+        };
+
+        /**
+           Type is the factory ClassCreator<T> uses:
+           ClassCreator_Factory<T> or, if ClassCreator_InlineStorage<T>
+           is enabled, Factory_InlineStorage<T>.
+        */
+        template <typename T, bool Inline = ClassCreator_InlineStorage<T>::Value>
+        struct ClassCreator_StorageFactory
+        {
+            typedef ClassCreator_Factory<T> Type;
+        };
+        template <typename T>
+        struct ClassCreator_StorageFactory<T, true>
+        {
+            typedef Factory_InlineStorage<T> Type;
+        };
+    }
+#endif
+
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES && !defined(DOXYGEN)
+    namespace Detail
+    {
+        /**
+           Holds the arguments of a ClassCreator::NewInstanceEmplace()
+           call until ClassCreator's constructor callback passes them
+           on to Factory::Emplace().
+        */
+        template <typename Factory, typename T, typename... Args>
+        struct FactoryEmplacer
+        {
+            std::tuple<Args &&...> args;
+            /** The object created by Create(), if any. */
+            T * result;
+            explicit FactoryEmplacer( Args &&... a )
+                : args( std::forward<Args>(a)... ), result(0)
+            {}
+            template <int... I>
+            T * call( v8::Persistent<v8::Object> & self, tmp::IndexList<I...> )
+            {
+                return Factory::Emplace( self, std::forward<Args>( std::get<I>(args) )... );
+            }
+            static T * Create( v8::Persistent<v8::Object> & self, void * state )
+            {
+                FactoryEmplacer & e( *static_cast<FactoryEmplacer *>(state) );
+                return e.result = e.call( self, typename tmp::MakeIndexList<sizeof...(Args)>::Type() );
+            }
+        };
+
+        /**
+           Value is true if Factory::Emplace() accepts (jsSelf, A) and
+           a T can be constructed from an A. The latter is checked
+           separately because Emplace() is usually an unconstrained
+           template, which would only fail when instantiated.
+        */
+        template <typename Factory, typename T, typename A>
+        struct FactoryCanEmplace
+        {
+        private:
+            template <typename F>
+            static char check( decltype( F::Emplace( std::declval<v8::Persistent<v8::Object> &>(),
+                                                     std::declval<A>() ) ) * );
+            template <typename F>
+            static long check( ... );
+        public:
+            enum { Value = std::is_constructible<T, A>::value
+                           && (1 == sizeof(check<Factory>(0))) };
+        };
+    }
+#endif
+
     /**
        A basic Native-to-JS class binding mechanism. This class does
        not aim to be a monster framework, just something simple,
@@ -575,7 +996,10 @@ namespace cvv8 {
         v8::Persistent<v8::FunctionTemplate> ctorTmpl;
         v8::Handle<v8::ObjectTemplate> protoTmpl;
         bool isSealed;
-        typedef ClassCreator_Factory<T> Factory;
+        typedef typename Detail::ClassCreator_StorageFactory<T>::Type Factory;
+        typedef ClassCreator_ExternalMemory<T> ExternalMem;
+        typedef Detail::ExternalMemoryTracker<T, ExternalMem::Value> ExternalMemTracker;
+        typedef Detail::ClassStatsTracker<T> StatsTracker;
         
         
         /**
@@ -584,16 +1008,17 @@ namespace cvv8 {
 
            This function tries to extract a native handle from jo by
            looking in the internal field defined by
-           ClassCreator_InternalFields<T>::NativeIndex.  If a native is
-           found in that field and it is the same as nh, then jo is
-           returned. If none is found, jo's prototype object is searched,
-           recursively, until either nh is found in the prototype chain or
-           the end of the chain is reached. If a match is found, the JS
-           object in which the native was found is returned. This does no
-           casting - it only compares by address.
-
-           If nh is not found anywhere in the chain, an empty handle is
-           returned.
+           ClassCreator_InternalFields<T>::NativeIndex (checking the
+           type ID field as well, if TypeIDIndex is not negative). If
+           a native is found in that field and it is the same as nh,
+           then jo is returned. If none is found and
+           ClassCreator_SearchPrototypeForThis<T> is true, the nearest
+           T native in jo's prototype chain is looked up the same way
+           JSToNative_ObjectWithInternalFields does it, and if it is nh
+           then the JS object in which it was found is returned. This
+           does no casting - it only compares by address.
+
+           If nh is not found, an empty handle is returned.
 
            Note that T must be non-cv qualified, so it is generally
            undesirable to allow the compiler to deduce its type from the
@@ -604,30 +1029,57 @@ namespace cvv8 {
                                                   T const * nh )
         {
             if( !nh || jo.IsEmpty() ) return v8::Handle<v8::Object>();
-            v8::Handle<v8::Value> proto(jo);
-            void const * ext = NULL;
-            typedef ClassCreator_SearchPrototypeForThis<T> SPFT;
-            while( !ext && !proto.IsEmpty() && proto->IsObject() )
+            typedef Detail::InternalFieldsLookup<InternalFields::Count,
+                                                 InternalFields::TypeIDIndex,
+                                                 InternalFields::NativeIndex> Lookup;
+            v8::Handle<v8::Object> holder;
+            void const * ext = Lookup::Find( jo, TypeID::Value,
+                                             ClassCreator_SearchPrototypeForThis<T>::Value,
+                                             &holder );
+            return (ext == nh) ? holder : v8::Handle<v8::Object>();
+        }
+        
+        /**
+           DeferredDeleteQueue::DeleteFunc implementation which passes
+           obj to Factory::Delete().
+        */
+        static void deleteTrampoline( void * obj )
+        {
+            Factory::Delete( static_cast<T*>(obj) );
+        }
+
+        /**
+           Passes native to Factory::Delete() or, if deferAllowed is
+           true and ClassCreator_DeferredDelete<T> is enabled, queues it
+           in DeferredDeleteQueue.
+        */
+        static void deleteNative( T * native, bool deferAllowed )
+        {
+            static_assert( !(ClassCreator_DeferredDelete<T>::Value
+                             && ClassCreator_DeleteIsThreadSafe<T>::Value
+                             && Detail::FactoryUsesPool<Factory>::Value),
+                           "ClassCreator_DeleteIsThreadSafe<T> must not be enabled for T's pooled "
+                           "(or inline) storage, which may only be freed by the v8 thread." );
+            ExternalMemTracker::Unwrapped( native );
+            StatsTracker::Destroyed( native, !deferAllowed /* i.e. via DestroyObject() */ );
+            if( deferAllowed && ClassCreator_DeferredDelete<T>::Value )
             {
-                v8::Local<v8::Object> const & obj( v8::Object::Cast( *proto ) );
-                ext = (obj->InternalFieldCount() != InternalFields::Count)
-                    ? NULL
-                    : obj->GetPointerFromInternalField( InternalFields::NativeIndex );
-                // FIXME: if InternalFields::TypeIDIndex>=0 then also do a check on that one.
-                /*
-                    If !ext, there is no bound pointer. If (ext &&
-                    (ext!=nh)) then there is one, but it's not the droid
-                    we're looking for. In either case, (possibly) check the
-                    prototype...
-                */
-                if( ext == nh ) return obj;
-                else if( !SPFT::Value ) break;
-                else proto = obj->GetPrototype();
+                DeferredDeleteQueue::Enqueue( native, deleteTrampoline,
+                                              ClassCreator_DeleteIsThreadSafe<T>::Value );
             }
-            return v8::Handle<v8::Object>();
+            else Factory::Delete( native );
         }
-        
+
         static void weak_dtor( v8::Persistent< v8::Value > pv, void *nobj )
+        {
+            weak_dtor_impl( pv, nobj, true );
+        }
+
+        /**
+           Implementation of weak_dtor(). deferAllowed is passed on to
+           deleteNative().
+        */
+        static void weak_dtor_impl( v8::Persistent< v8::Value > pv, void *nobj, bool deferAllowed )
         {
             using namespace v8;
             //std::cerr << "Entering weak_dtor<>(native="<<(void const *)nobj<<")\n";
@@ -692,6 +1144,8 @@ namespace cvv8 {
                         << ", jobj field count="<<jobj->InternalFieldCount()
                         << "\nTHIS MAY LEAD TO A CRASH IF THIS JS HANDLE IS USED AGAIN!!!\n"
                         ;
+                    ExternalMemTracker::Unwrapped( native );
+                    StatsTracker::Destroyed( native, !deferAllowed );
                     Factory::Delete(native);
                     pv.Dispose(); pv.Clear(); /* see comments below!*/
                     v8::ThrowException(msg.toError());
@@ -704,7 +1158,7 @@ namespace cvv8 {
                     {
                         nholder->SetInternalField( InternalFields::TypeIDIndex, Null() );
                     }
-                    Factory::Delete(native);
+                    deleteNative( native, deferAllowed );
                 }
 #else
                 WeakWrap::Unwrap( nholder, native );
@@ -713,7 +1167,7 @@ namespace cvv8 {
                 {
                     nholder->SetInternalField( InternalFields::TypeIDIndex, Null() );
                 }
-                Factory::Delete(native);
+                deleteNative( native, deferAllowed );
 #endif
             }
             /*
@@ -727,26 +1181,102 @@ namespace cvv8 {
             pv.Clear();
         }
 
+        /**
+           A request, made by NewInstanceWrapping() or
+           NewInstanceEmplace(), to create the native for the next
+           new JS object with create() instead of Factory::Create().
+        */
+        struct PendingCreate
+        {
+            T * (*create)( v8::Persistent<v8::Object> & jself, void * state );
+            void * state;
+            /**
+               Set by construct() once create() has returned, from
+               which point the new JS object owns (or has already
+               destroyed) the native.
+            */
+            bool taken;
+        };
+
+        /** The current thread's outstanding PendingCreate, if any. */
+        static PendingCreate *& pendingCreate()
+        {
+            static CVV8_THREAD_LOCAL PendingCreate * bob = 0;
+            return bob;
+        }
+
+        /**
+           Calls NewInstance(0,NULL) with pc as the pending creation
+           request. The request is withdrawn when this returns, whether
+           or not ctor_proxy() took it.
+        */
+        v8::Handle<v8::Object> newInstanceVia( PendingCreate & pc )
+        {
+            struct Sentry
+            {
+                PendingCreate * const prev;
+                explicit Sentry( PendingCreate & p ) : prev( pendingCreate() )
+                {
+                    pendingCreate() = &p;
+                }
+                ~Sentry()
+                {
+                    pendingCreate() = prev;
+                }
+            } const sentry( pc );
+            return this->NewInstance( 0, NULL );
+        }
+
+        /** Returns the native stored in obj, a T created by this class. */
+        static T * nativeOf( v8::Handle<v8::Object> const & obj )
+        {
+            return static_cast<T *>( obj->GetPointerFromInternalField( InternalFields::NativeIndex ) );
+        }
+
+        /** PendingCreate::create() impl for NewInstanceWrapping(). */
+        static T * adoptNative( v8::Persistent<v8::Object> &, void * native )
+        {
+            return static_cast<T *>(native);
+        }
+
         /**
            Gets installed as the NewInstance() handler for T.
          */
         static v8::Handle<v8::Value> ctor_proxy( v8::Arguments const & argv )
         {
-            using namespace v8;
-            if(ClassCreator_AllowCtorWithoutNew<T>::Value)
+            if (argv.IsConstructCall())
+            {
+                return construct( argv.This()
+                                  /*CastToJS<T>(*nobj)
+
+                                  We are not yet far enough
+                                  along in the binding that
+                                  CastToJS() can work. And it
+                                  can't work for the generic
+                                  case, anyway.
+                                  */, argv );
+            }
+            else if(ClassCreator_AllowCtorWithoutNew<T>::Value)
             {
                 /**
-                   Allow construction without 'new' by forcing this
-                   function to be called in a ctor context...
+                   Allow construction without 'new'. Instead of
+                   calling the ctor again with 'new' (which requires a
+                   copy of argv and a second trip through v8 and this
+                   function), create the object from the instance
+                   template, which gives it the same prototype and
+                   internal fields, and construct the native from
+                   this call's arguments.
                 */
-                if (!argv.IsConstructCall()) 
+                v8::Local<v8::Object> jobj;
+                try
+                {
+                    jobj = Instance().ctorTmpl->InstanceTemplate()->NewInstance();
+                }
+                catch( std::exception const & ex )
                 {
-                    const int argc = argv.Length();
-                    Handle<Function> ctor( Function::Cast(*argv.Callee()));
-                    std::vector< Handle<Value> > av(static_cast<size_t>(argc),Undefined());
-                    for( int i = 0; i < argc; ++i ) av[i] = argv[i];
-                    return ctor->NewInstance( argc, &av[0] );
+                    return Toss( CastToJS(ex) );
                 }
+                return construct( jobj, argv );
             }
             else
             {
@@ -756,27 +1286,35 @@ namespace cvv8 {
                    "v8::Object::SetInternalField() Writing internal
                    field out of bounds".
                 */
-                if (!argv.IsConstructCall()) 
-                {
-                    return Toss("This constructor cannot be called as function!");
-                }
+                return Toss("This constructor cannot be called as function!");
             }
-            Local<Object> const & jobj( argv.This()
-                                        /*CastToJS<T>(*nobj)
-                                          
-                                        We are not yet far enough
-                                        along in the binding that
-                                        CastToJS() can work. And it
-                                        can't work for the generic
-                                        case, anyway.
-                                        */);
+        }
+
+        /**
+           Implementation of ctor_proxy(): creates a native from argv
+           and binds it to jobj, a new instance of this class.
+        */
+        static v8::Handle<v8::Value> construct( v8::Local<v8::Object> const & jobj,
+                                                v8::Arguments const & argv )
+        {
+            using namespace v8;
             if( jobj.IsEmpty() ) return jobj /* assume exception*/;
             Persistent<Object> self( Persistent<Object>::New(jobj) );
+            PendingCreate * const pc = pendingCreate();
+            if( pc )
+            {   /* Take it before anything else can construct a T. */
+                pendingCreate() = NULL;
+            }
             T * nobj = NULL;
             try
             {
                 WeakWrap::PreWrap( self, argv  );
-                nobj = Factory::Create( self, argv );
+                if( pc )
+                {
+                    nobj = pc->create( self, pc->state );
+                    pc->taken = true;
+                }
+                else nobj = Factory::Create( self, argv );
                 if( ! nobj && !ClassCreator_AllowNullConstructor<T>::Value )
                 {
                     return CastToJS<std::exception>(std::runtime_error("Native constructor failed."));
@@ -795,6 +1333,11 @@ namespace cvv8 {
                        client mis-uses the internal fields.
                     */
                     ;
+                if( nobj )
+                {
+                    ExternalMemTracker::Wrapped( nobj, ExternalMem::Size( *nobj ) );
+                    StatsTracker::Created( nobj );
+                }
             }
             catch(std::exception const &ex)
             {
@@ -819,6 +1362,14 @@ namespace cvv8 {
               isSealed(false)
         {
             ctorTmpl->InstanceTemplate()->SetInternalFieldCount(InternalFields::Count);
+#if CVV8_CONFIG_ENABLE_CLASS_STATS
+            StatsTracker::Register( TypeName<T>::Value );
+#endif
+            if( ClassCreator_CreateMany<T>::Value )
+            {
+                ctorTmpl->Set( SymbolCache::Get("createMany"),
+                               v8::FunctionTemplate::New( CreateManyCallback ) );
+            }
         }
     public:
         /**
@@ -828,10 +1379,27 @@ namespace cvv8 {
 
         /**
            Returns the shared instance of this class.
+
+           The instance holds v8 templates, which belong to the isolate
+           which first calls this. If the library is built with
+           CVV8_CONFIG_HAS_ISOLATE_LOCKING, calling it from any other
+           isolate (e.g. a V8ShellPool worker's) throws a
+           std::runtime_error. The callbacks this class installs
+           report that as a JS exception.
         */
         static ClassCreator & Instance()
         {
             static ClassCreator bob;
+#if CVV8_CONFIG_HAS_ISOLATE_LOCKING
+            static v8::Isolate * const owner = v8::Isolate::GetCurrent();
+            if( v8::Isolate::GetCurrent() != owner )
+            {
+                StringBuffer msg;
+                msg << "ClassCreator<" << TypeName<T>::Value
+                    << "> cannot be used outside of the isolate which created it.";
+                throw std::runtime_error( msg.Content() );
+            }
+#endif
             return bob;
         }
 
@@ -925,6 +1493,164 @@ namespace cvv8 {
             }
         }
 
+        /**
+            Creates count new instances, as if NewInstance(argc, argv)
+            were called count times, and returns them in a JS array.
+            On error an empty handle is returned (and a JS exception is
+            probably propagating) and any instances created so far are
+            left to the garbage collector.
+
+            Compared to calling NewInstance() in a loop, this looks up
+            the constructor function once, creates each object in its
+            own short-lived HandleScope, and first calls
+            Factory::Reserve(count), if the factory has such a function,
+            so that it can allocate for all of them at once.
+            ClassCreator_Factory_Pooled reserves all of the blocks up
+            front, carved from contiguous slabs, and
+            ClassCreator_Factory_NativeToJSMap grows its mapping table
+            once.
+        */
+        v8::Handle<v8::Array> NewInstances( uint32_t count, int argc = 0,
+                                            v8::Handle<v8::Value> argv[] = NULL )
+        {
+            v8::HandleScope hsc;
+            v8::Handle<v8::Function> const ctor( this->CtorFunction() );
+            Detail::FactoryReserve<Factory>::Reserve( count );
+            v8::Handle<v8::Array> const ar( v8::Array::New( static_cast<int>(count) ) );
+            for( uint32_t i = 0; i < count; ++i )
+            {
+                v8::HandleScope inner;
+                v8::Handle<v8::Object> const obj( ctor->NewInstance( argc, argv ) );
+                if( obj.IsEmpty() ) return v8::Handle<v8::Array>();
+                ar->Set( i, obj );
+            }
+            return hsc.Close( ar );
+        }
+
+        /**
+            v8::InvocationCallback with the JS interface:
+
+            @code
+            Array createMany( int count [, constructor arguments...] )
+            @endcode
+
+            which returns NewInstances(count, ...), passing it any
+            arguments after count. It is installed as T.createMany()
+            if ClassCreator_CreateMany<T> is enabled.
+        */
+        static v8::Handle<v8::Value> CreateManyCallback( v8::Arguments const & argv )
+        {
+            int32_t const n = (argv.Length() > 0) ? argv[0]->Int32Value() : 0;
+            if( n < 0 ) return Toss("createMany() count must not be negative!");
+            std::vector< v8::Handle<v8::Value> > av;
+            for( int i = 1; i < argv.Length(); ++i ) av.push_back( argv[i] );
+            try
+            {
+                return Instance().NewInstances( static_cast<uint32_t>(n),
+                                                static_cast<int>(av.size()),
+                                                av.empty() ? NULL : &av[0] );
+            }
+            catch( std::exception const & ex )
+            {
+                return Toss( CastToJS(ex) );
+            }
+        }
+
+        /**
+            Creates a new JS object which wraps native, without calling
+            Factory::Create(). Ownership of native passes to the new JS
+            object in all cases: it is eventually destroyed via
+            Factory::Delete(), so it must have been allocated the way
+            the Factory deallocates. If creating the JS object fails,
+            native is destroyed immediately and an empty handle is
+            returned (and a JS exception is probably propagating).
+
+            ClassCreator_WeakWrap<T>::PreWrap() is passed an empty
+            argument list.
+        */
+        v8::Handle<v8::Object> NewInstanceWrapping( T * native )
+        {
+            if( !native ) return v8::Handle<v8::Object>();
+            PendingCreate pc = { &adoptNative, native, false };
+            v8::Handle<v8::Object> const obj( this->newInstanceVia( pc ) );
+            if( !pc.taken ) Factory::Delete( native );
+            return obj;
+        }
+
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+        /**
+            Creates a new JS object whose native is created by
+            ClassCreator_Factory<T>::Emplace(jsSelf, args...), which
+            must exist, instead of by Factory::Create(). On success tgt
+            is set to the new native, otherwise it is set to NULL and
+            an empty handle is returned.
+
+            This lets native code create JS-bound objects with any
+            constructor, not just those reachable via JS arguments,
+            constructing the native only once.
+
+            Requires CVV8_CONFIG_HAS_VARIADIC_TEMPLATES.
+        */
+        template <typename... Args>
+        v8::Handle<v8::Object> NewInstanceEmplace( T * & tgt, Args &&... args )
+        {
+            typedef Detail::FactoryEmplacer<Factory, T, Args...> Emplacer;
+            Emplacer em( std::forward<Args>(args)... );
+            PendingCreate pc = { &Emplacer::Create, &em, false };
+            v8::Handle<v8::Object> const obj( this->newInstanceVia( pc ) );
+            tgt = obj.IsEmpty() ? NULL : em.result;
+            return obj;
+        }
+#endif
+
+        /**
+            Creates a new JS object holding a copy of src. If the
+            Factory has an Emplace() function (and
+            CVV8_CONFIG_HAS_VARIADIC_TEMPLATES is true) the copy is
+            constructed directly, else the object is created via
+            Factory::Create() and src is assigned to it.
+
+            Returns an empty handle on error.
+        */
+        v8::Handle<v8::Object> NewInstanceFrom( Type const & src )
+        {
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+            return this->newInstanceFrom( src,
+                tmp::BoolVal< Detail::FactoryCanEmplace<Factory, Type, Type const &>::Value >() );
+#else
+            v8::Handle<v8::Object> const obj( this->NewInstance( 0, NULL ) );
+            if( !obj.IsEmpty() ) *this->nativeOf( obj ) = src;
+            return obj;
+#endif
+        }
+
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+        /**
+            Overload of NewInstanceFrom() which moves src instead of
+            copying it.
+        */
+        v8::Handle<v8::Object> NewInstanceFrom( Type && src )
+        {
+            return this->newInstanceFrom( std::move(src),
+                tmp::BoolVal< Detail::FactoryCanEmplace<Factory, Type, Type &&>::Value >() );
+        }
+    private:
+        template <typename V>
+        v8::Handle<v8::Object> newInstanceFrom( V && src, tmp::BoolVal<true> )
+        {
+            T * tgt = NULL;
+            return this->NewInstanceEmplace( tgt, std::forward<V>(src) );
+        }
+        template <typename V>
+        v8::Handle<v8::Object> newInstanceFrom( V && src, tmp::BoolVal<false> )
+        {
+            v8::Handle<v8::Object> const obj( this->NewInstance( 0, NULL ) );
+            if( !obj.IsEmpty() ) *this->nativeOf( obj ) = std::forward<V>(src);
+            return obj;
+        }
+    public:
+#endif
+
         /**
            Convenience method to add the given property to the
            prototype. Returns this object, for call chaining.
@@ -935,13 +1661,13 @@ namespace cvv8 {
         template <typename ValueT>
         inline ClassCreator & Set( char const * name, ValueT val )
         {
-            this->protoTmpl->Set(v8::String::NewSymbol(name), CastToJS(val));
+            this->protoTmpl->Set(SymbolCache::Get(name), CastToJS(val));
             return *this;
         }
         //! Not quite sure why i need this overload, but i do.
         inline ClassCreator & Set( char const * name, v8::InvocationCallback val )
         {
-            this->protoTmpl->Set(v8::String::NewSymbol(name), CastToJS(val));
+            this->protoTmpl->Set(SymbolCache::Get(name), CastToJS(val));
             return *this;
         }
         /**
@@ -967,7 +1693,7 @@ namespace cvv8 {
         */
         inline void AddClassTo( char const * thisClassName, v8::Handle<v8::Object> const & dest )
         {
-            dest->Set(v8::String::NewSymbol(thisClassName),
+            dest->Set(SymbolCache::Get(thisClassName),
                       this->CtorFunction());
         }
 
@@ -995,7 +1721,7 @@ namespace cvv8 {
             {
                 v8::Persistent<v8::Object> p( v8::Persistent<v8::Object>::New( jo ) );
                 p.ClearWeak(); // avoid a second call to weak_dtor() via gc!
-                weak_dtor( p, t );
+                weak_dtor_impl( p, t, false );
                 return true;
             }
         }
@@ -1027,6 +1753,18 @@ namespace cvv8 {
                 return DestroyObject(argv.This()) ? v8::True() : v8::False();
         }
 
+        /**
+            If ClassCreator_ExternalMemory<T> is enabled and obj is a
+            wrapped T, the amount of external memory reported to v8
+            for it is updated to ClassCreator_ExternalMemory<T>::Size(*obj).
+            Otherwise this is a no-op. Call it after an object's native
+            footprint changes significantly.
+        */
+        static void ExternalMemoryResized( T const * obj )
+        {
+            if( obj ) ExternalMemTracker::Resized( obj, ExternalMem::Size( *obj ) );
+        }
+
         /**
             Tells v8 that this bound type inherits ParentType. 
             ParentType _must_ be a class wrapped by ClassCreator. 
@@ -1036,6 +1774,15 @@ namespace cvv8 {
             avoid accidental mis-use caused by registering a 
             subclass of a class which has not yet been bound (and may
             may never be bound).
+
+            If T publicly and non-virtually inherits ParentType in C++
+            (see ClassHierarchy::IsNativeBase), it also registers the
+            relationship with ClassHierarchy, so that ParentType's
+            methods accept T objects as their 'this' (with the pointer
+            adjusted for T's layout) and so that
+            NativeToJSMap<ParentType> knows about T instances. Other
+            types (e.g. ones which only inherit ParentType on the JS
+            side) only get the JS-side inheritance.
         */
         template <typename ParentType>
         void Inherit()
@@ -1051,7 +1798,18 @@ namespace cvv8 {
                 throw std::runtime_error(os.str());
             }
             this->CtorTemplate()->Inherit( p.CtorTemplate() );
+            this->registerParent<ParentType>( tmp::BoolVal< ClassHierarchy::IsNativeBase<T, ParentType>::Value >() );
+        }
+    private:
+        template <typename ParentType>
+        static void registerParent( tmp::BoolVal<true> )
+        {
+            ClassHierarchy::Register<T, ParentType>();
         }
+        template <typename ParentType>
+        static void registerParent( tmp::BoolVal<false> )
+        {}
+    public:
 
         /**
             Simply runs ClassCreator_SetupBindings<T>::Initialize( target ).
@@ -1061,9 +1819,47 @@ namespace cvv8 {
         {
             ClassCreator_SetupBindings<T>::Initialize( target );
         }
+
+        /**
+            Arranges for SetupBindings(target) to be run the first time
+            a script reads target[name], instead of now. name must be
+            the name under which the setup stores the class (or
+            anything else it defines in target). See LazyBinding.
+        */
+        static void SetupBindingsLazily( v8::Handle<v8::Object> const & target, char const * name )
+        {
+            LazyBinding< void (v8::Handle<v8::Object> const &), &ClassCreator::SetupBindings >
+                ::Add( target, name );
+        }
         
     };
 
+#if !defined(DOXYGEN)
+    namespace Detail
+    {
+        /**
+           The TypeSafe JSToNative_ClassCreator implementation: a
+           type-checked lookup which falls back to
+           ClassHierarchy::Upcast<T>() for objects whose type ID is
+           not T's.
+        */
+        template <typename T>
+        struct JSToNative_ClassCreator_TypeSafe
+        {
+            typedef typename TypeInfo<T>::NativeHandle ResultType;
+            ResultType operator()( v8::Handle<v8::Value> const & h ) const
+            {
+                typedef ClassCreator_InternalFields<T> IF;
+                typedef InternalFieldsLookup<IF::Count, IF::TypeIDIndex, IF::NativeIndex> Lookup;
+                void * const ext = Lookup::Find( h, ClassCreator_TypeID<T>::Value,
+                                                 ClassCreator_SearchPrototypeForThis<T>::Value,
+                                                 NULL, &ClassHierarchy::Upcast<T> );
+                return ext ? static_cast<ResultType>(ext) : NULL;
+            }
+        };
+    }
+#endif // !DOXYGEN
+
     /**
         Intended to be the base class for JSToNative<T> specializations
         when T is JS-bound using ClassCreator.
@@ -1079,8 +1875,10 @@ namespace cvv8 {
         irrelevant, but when specializing any of them, they must come before
         this JSToNative implementation is instantiated.
 
-        If TypeSafe is true then this type is a proxy for
-        JSToNative_ObjectWithInternalFieldsTypeSafe, else it is a proxy for
+        If TypeSafe is true then this type works like
+        JSToNative_ObjectWithInternalFieldsTypeSafe, except that it also
+        accepts objects holding a subclass of T registered with
+        ClassHierarchy (see ClassCreator::Inherit()), else it is a proxy for
         JSToNative_ObjectWithInternalFields. Note that ClassCreator is
         hard-wired to implant/deplant type id information if
         ClassCreator_InternalFields<T>::TypeIDIndex is not negative, with the
@@ -1092,13 +1890,7 @@ namespace cvv8 {
     template <typename T, bool TypeSafe = ClassCreator_InternalFields<T>::TypeIDIndex >= 0 >
     struct JSToNative_ClassCreator :
         tmp::IfElse< TypeSafe,
-            JSToNative_ObjectWithInternalFieldsTypeSafe<T,
-                                            ClassCreator_TypeID<T>::Value,
-                                            ClassCreator_InternalFields<T>::Count,
-                                            ClassCreator_InternalFields<T>::TypeIDIndex,
-                                            ClassCreator_InternalFields<T>::NativeIndex,
-                                            ClassCreator_SearchPrototypeForThis<T>::Value
-                                            >,
+            Detail::JSToNative_ClassCreator_TypeSafe<T>,
             JSToNative_ObjectWithInternalFields<T,
                                             ClassCreator_InternalFields<T>::Count,
                                             ClassCreator_InternalFields<T>::NativeIndex,
@@ -1108,26 +1900,6 @@ namespace cvv8 {
     {
     };
 
-#if 0
-    //! Experimental.
-    template <typename ParentT, typename SubT >
-    struct JSToNative_ClassCreator_Subclass
-    {
-        typedef typename TypeInfo<SubT>::NativeHandle ResultType;
-        ResultType operator()( v8::Handle<v8::Value> const & h ) const
-        {
-            typedef typename TypeInfo<ParentT>::NativeHandle PTP;
-            PTP typeCheck; typeCheck = (ResultType)NULL
-                /* If compiler errors led you here then SubT probably does not
-                    publicly subclass ParentT. */
-                ;
-            PTP p = CastFromJS<ParentT>(h);
-            //std::cerr << "dyncast="<<dynamic_cast<ResultType>(p)<<"\n";
-            return p ? dynamic_cast<ResultType>(p) : NULL; 
-        }
-    };
-#endif
-
 #if !defined(DOXYGEN)
     namespace Detail
     {
@@ -1144,6 +1916,14 @@ namespace cvv8 {
             {
                 delete nself;
             }
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+            /** Returns (new Type(args...)). See ClassCreator_Factory::Emplace(). */
+            template <typename... Args>
+            static NativeHandle Emplace( v8::Persistent<v8::Object> &, Args &&... args )
+            {
+                return new Type( std::forward<Args>(args)... );
+            }
+#endif
         protected:
             /**
                If argv.Length() >= Arity then this function ignores errmsg and
@@ -1228,6 +2008,28 @@ namespace cvv8 {
             N2JMap::Remove( nself );
             delete nself;
         }
+
+        /**
+            Makes room in N2JMap for n more mappings (see
+            ClassCreator::NewInstances()).
+        */
+        static void Reserve( std::size_t n )
+        {
+            N2JMap::Reserve( N2JMap::Count() + n );
+        }
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+        /**
+            Like Create(), but constructs the native with (new
+            Type(args...)). See ClassCreator_Factory::Emplace().
+        */
+        template <typename... Args>
+        static NativeHandle Emplace( v8::Persistent<v8::Object> & jself, Args &&... args )
+        {
+            NativeHandle n = new Type( std::forward<Args>(args)... );
+            N2JMap::Insert( jself, n );
+            return n;
+        }
+#endif
     };
 
     /** @deprecated Use ClassCreator_Factory_Dispatcher instead (same interface).
@@ -1288,6 +2090,131 @@ namespace cvv8 {
         }
     };
 
+    /**
+        A ClassCreator_Factory implementation which allocates T objects
+        from a pool of fixed-size blocks instead of via (new T), for
+        types which are created and garbage-collected at a high rate.
+        Deleting an object (e.g. from the GC's weak-pointer callback)
+        returns its memory to the pool's free-list without going
+        through the system allocator.
+
+        CtorT is the constructor proxy used to construct objects in the
+        pooled memory. It must provide the CallInPlace() interface of
+        CtorForwarder, e.g. a CtorForwarder or CtorArityDispatcher.
+
+        Example:
+
+        @code
+        template <>
+        struct ClassCreator_Factory<MyType> :
+            ClassCreator_Factory_Pooled< MyType, CtorForwarder<MyType *(int)> >
+        {};
+        @endcode
+
+        If Tag is void, the pool is shared by all types whose size
+        rounds up to the same size class (see Stats()). Any other Tag
+        type gives the objects a pool of their own, with blocks of
+        sizeof(T) rounded up to T's alignment (ClassCreator_InlineStorage
+        uses this). The pool is not thread-safe, so objects must be
+        created and destroyed only while holding the v8 lock (which is
+        the case for objects destroyed by the GC). For that reason,
+        ClassCreator_DeleteIsThreadSafe<T> must not be enabled for
+        types using this factory (doing so triggers a compile-time
+        error if ClassCreator_DeferredDelete<T> is enabled as well).
+
+        Delete() must only be passed objects created by Create(), and
+        they must be exactly of type T (not a subclass).
+
+        The slabs come from ::operator new(), so T must not need more
+        than the default alignment (e.g. alignas(32) SIMD types are
+        rejected at compile time).
+    */
+    template <typename T, typename CtorT, typename Tag>
+    struct ClassCreator_Factory_Pooled
+    {
+    public:
+        typedef typename TypeInfo<T>::Type Type;
+        typedef typename TypeInfo<T>::NativeHandle NativeHandle;
+        static_assert( std::alignment_of<Type>::value <= alignof(std::max_align_t),
+                       "ClassCreator_Factory_Pooled cannot store over-aligned types." );
+        /** The pool from which Type objects are allocated. */
+        typedef Detail::SlabPool< Detail::PooledBlockSize<Type, Tag>::Value, Tag > Pool;
+
+        /**
+            Allocates a block from the pool and constructs a Type in it
+            via CtorT::CallInPlace(). If construction fails, the block
+            is returned to the pool and the exception (if any) is
+            propagated.
+        */
+        static NativeHandle Create( v8::Persistent<v8::Object> , v8::Arguments const &  argv )
+        {
+            Pool & pool( Pool::Instance() );
+            void * mem = pool.Allocate();
+            NativeHandle rc = 0;
+            try
+            {
+                rc = CtorT::CallInPlace( mem, argv );
+            }
+            catch(...)
+            {
+                pool.Deallocate( mem );
+                throw;
+            }
+            if( ! rc ) pool.Deallocate( mem );
+            return rc;
+        }
+
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+        /**
+            Allocates a block from the pool and constructs a
+            Type(args...) in it. See ClassCreator_Factory::Emplace().
+        */
+        template <typename... Args>
+        static NativeHandle Emplace( v8::Persistent<v8::Object> &, Args &&... args )
+        {
+            Pool & pool( Pool::Instance() );
+            void * mem = pool.Allocate();
+            try
+            {
+                return new (mem) Type( std::forward<Args>(args)... );
+            }
+            catch(...)
+            {
+                pool.Deallocate( mem );
+                throw;
+            }
+        }
+#endif
+
+        /**
+            Calls nself's destructor and returns its memory to the pool.
+        */
+        static void Delete( NativeHandle nself )
+        {
+            if( ! nself ) return;
+            nself->~Type();
+            Pool::Instance().Deallocate( nself );
+        }
+
+        /**
+            Pre-allocates room for at least n more objects.
+        */
+        static void Reserve( std::size_t n )
+        {
+            Pool::Instance().Reserve( n );
+        }
+
+        /**
+            Returns the statistics of the pool used by this type. Note
+            that, unless Tag is used, types in the same size class
+            share a pool, and therefore share the statistics.
+        */
+        static PoolStats Stats()
+        {
+            return Pool::Instance().Stats();
+        }
+    };
+
     /**
        A special-case factory implementation for use when T
        is abstract or otherwise should not be instantiable
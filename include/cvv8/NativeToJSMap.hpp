@@ -2,8 +2,109 @@
 #define V8_CONVERT_NATIVE_JS_MAPPER_HPP_INCLUDED
 
 #include "detail/convert_core.hpp"
+#include "detail/ptr_hash_map.hpp"
+#include "detail/class_hierarchy.hpp"
 namespace cvv8
 {
+    template <typename T> class ClassCreator;
+    template <typename T> struct ClassCreator_InternalFields;
+
+    /**
+       A NativeToJSMap<T> policy class which specifies whether the
+       mappings for T should be stored in an open-addressing hash
+       table (if Value is true) or in a std::map (if Value is false,
+       the default).
+
+       The hash table gives O(1) lookups and does not allocate per
+       bound object, which pays off for types which have many (tens
+       of thousands or more) live JS-bound instances. For types with
+       only a handful of instances the difference is negligible.
+
+       To enable it for a given type:
+
+       @code
+       namespace cvv8 {
+           template <>
+           struct NativeToJSMap_UseHashTable<MyType> : tmp::BoolVal<true> {};
+       }
+       @endcode
+    */
+    template <typename T>
+    struct NativeToJSMap_UseHashTable : tmp::BoolVal<false>
+    {};
+
+    /**
+       A NativeToJSMap<T> policy class for tuning the hash table used
+       when NativeToJSMap_UseHashTable<T>::Value is true. It is unused
+       for std::map-based storage.
+
+       Hash must be a default-constructible functor with the signature
+       (std::size_t (void const *)). The default implementation mixes
+       the pointer bits so that the alignment-induced zero bits of
+       heap addresses do not cause clustering.
+
+       MaxLoadPercent is the fill ratio (1-99) past which the table
+       doubles in size. Lower values trade memory for shorter probe
+       sequences.
+    */
+    template <typename T>
+    struct NativeToJSMap_HashPolicy
+    {
+        typedef Detail::PtrHash Hash;
+        enum { MaxLoadPercent = 75 };
+    };
+
+#if !defined(DOXYGEN)
+    namespace Detail
+    {
+        /**
+           std::map-based storage for NativeToJSMap.
+        */
+        template <typename ValueT>
+        struct NativeToJSMap_TreeStorage
+        {
+        private:
+            typedef std::map<void const *, ValueT> MapT;
+            MapT map;
+        public:
+            ValueT * Find( void const * key )
+            {
+                typename MapT::iterator it = map.find(key);
+                return (map.end() == it) ? 0 : &it->second;
+            }
+            bool Insert( void const * key, ValueT const & val )
+            {
+                if( !key ) return false;
+                map[key] = val;
+                return true;
+            }
+            bool Erase( void const * key, ValueT * tgt )
+            {
+                typename MapT::iterator it = map.find(key);
+                if( map.end() == it ) return false;
+                if( tgt ) *tgt = it->second;
+                map.erase(it);
+                return true;
+            }
+            void Reserve( std::size_t ) {}
+            std::size_t Size() const { return map.size(); }
+        };
+
+        /**
+           Selects the NativeToJSMap storage type for T based on
+           NativeToJSMap_UseHashTable<T> and NativeToJSMap_HashPolicy<T>.
+        */
+        template <typename T, typename ValueT>
+        struct NativeToJSMap_Storage
+            : tmp::IfElse< NativeToJSMap_UseHashTable<T>::Value,
+                           PtrHashMap< ValueT,
+                                       typename NativeToJSMap_HashPolicy<T>::Hash,
+                                       NativeToJSMap_HashPolicy<T>::MaxLoadPercent >,
+                           NativeToJSMap_TreeStorage<ValueT> >
+        {};
+    }
+#endif // DOXYGEN
+
     /**
        A helper class to assist in the "two-way-binding" of
        natives to JS objects. This class holds native-to-JS
@@ -17,22 +118,20 @@ namespace cvv8
        types (e.g. v8::Handle<v8::Value>) then no native-to-JS
        conversion is typically needed.
 
-       Known limitations:
-
-       This type does not fully support subclass conversions.
-       e.g. the following function binding:
+       Subclasses: if T is registered as a subclass of some ParentType
+       (see ClassHierarchy, which ClassCreator<T>::Inherit() uses),
+       Insert() and Remove() also update NativeToJSMap<ParentType>,
+       using the address of the ParentType part of the object. Thus a
+       binding such as:
 
        @code
        virtual MyType * (MyType::*)();
        @endcode
 
-       _should_ be able to return a MySubType from derived implementations
-       but it currently cannot. Handling this requires that a parent class
-       be told each of its subclasses, and that we add internal handlers
-       which try lookups on those classes if a conversion to MyType fails.
-
-       Reminder to self: the v8::juice tree has an example of that which we
-       can probably plunder.
+       can return a MySubType from derived implementations, and
+       CastToJS() will find the MySubType JS object. The cost is one
+       extra mapping per registered ancestor of each bound subclass
+       instance.
     */
     template <typename T>
     struct NativeToJSMap
@@ -48,8 +147,9 @@ namespace cvv8
         typedef v8::Persistent<v8::Object> JSObjHandle;
         //typedef v8::Handle<v8::Object> JSObjHandle; // Hmmm.
         typedef std::pair<NativeHandle,JSObjHandle> ObjBindT;
-        typedef std::map<const void*, ObjBindT> OneOfUsT;
-        /** Maps (void const *) to ObjBindT.
+        typedef typename Detail::NativeToJSMap_Storage<T,ObjBindT>::Type OneOfUsT;
+        /** Maps (void const *) to ObjBindT. The storage type is
+            selected by the NativeToJSMap_UseHashTable<T> policy.
         
             Reminder to self: we might need to make this map a static
             non-function member to work around linking problems (at 
@@ -69,15 +169,10 @@ namespace cvv8
          else true. */
         static bool Insert( const JSObjHandle jself, NativeHandle obj )
         {
-            if( obj )
-			{
-				Map()[ obj ] = std::make_pair( obj, jself );
-				return true;
-			}
-			else
-			{
-				return false;
-			}
+            if( !obj ) return false;
+            Map().Insert( obj, std::make_pair( obj, jself ) );
+            ClassHierarchy::Mirror<T>( obj, &jself );
+            return true;
         }
 
         /**
@@ -86,19 +181,24 @@ namespace cvv8
         */
         static NativeHandle Remove( const void* key )
         {
-            typedef typename OneOfUsT::iterator Iterator;
-            OneOfUsT & map( Map() );
-            Iterator it = map.find( key );
-            if( map.end() == it )
-            {
-                return 0;
-            }
-            else
-            {
-                NativeHandle victim = it->second.first;
-                map.erase(it);
-                return victim;
-            }
+            ObjBindT victim;
+            if( !Map().Erase( key, &victim ) ) return 0;
+            ClassHierarchy::Mirror<T>( victim.first, NULL );
+            return victim.first;
+        }
+
+        /**
+           ClassHierarchy::MirrorFunc implementation which maps native
+           to *jself or, if jself is NULL, unmaps it. Unlike
+           Insert()/Remove() it does not touch the maps of T's own
+           ancestors (ClassHierarchy::Mirror() visits all of them
+           directly).
+        */
+        static void MirrorMapping( void const * native, JSObjHandle const * jself )
+        {
+            NativeHandle const n = static_cast<NativeHandle>(native);
+            if( jself ) Map().Insert( n, std::make_pair( n, *jself ) );
+            else Map().Erase( n, NULL );
         }
 
         /**
@@ -108,13 +208,8 @@ namespace cvv8
         static NativeHandle GetNative( const void* key )
         {
             if( ! key ) return nullptr;
-            else
-            {
-                typename OneOfUsT::iterator it = Map().find(key);
-                return (Map().end() == it)
-                    ? 0
-                    : it->second.first;
-            }
+            ObjBindT const * b = Map().Find(key);
+            return b ? b->first : 0;
         }
 
         /**
@@ -123,17 +218,29 @@ namespace cvv8
         */
         static JSObjHandle GetJSObject( const void* key )
         {
-            if( !key )
-				return JSObjHandle();
-
-			auto it = Map().find(key);
+            if( !key ) return JSObjHandle();
+            ObjBindT const * b = Map().Find(key);
+            return b ? b->second : JSObjHandle();
+        }
 
-            if( Map().end() == it )
-				return JSObjHandle();
+        /**
+           Pre-allocates room for at least n mappings. This is a no-op
+           unless NativeToJSMap_UseHashTable<T> is enabled, in which case
+           it can be used to avoid incremental rehashing when a large
+           number of objects is about to be bound.
+        */
+        static void Reserve( std::size_t n )
+        {
+            Map().Reserve( n );
+        }
 
-            else
-				return it->second.second;
-		}
+        /**
+           Returns the number of currently-mapped natives.
+        */
+        static std::size_t Count()
+        {
+            return Map().Size();
+        }
         
         /**
             A base NativeToJS<T> implementation for classes which use NativeToJSMap<T>
@@ -144,71 +251,64 @@ namespace cvv8
             template <>
             struct NativeToJS<MyType> : NativeToJSMap<MyType>::NativeToJSImpl {};
             @endcode
+
+            Pointers which are not mapped yet are wrapped in a new JS
+            object, which takes ownership of them (see
+            ClassCreator::NewInstanceWrapping()). Values are copied (or,
+            for rvalues, moved) into a new JS object (see
+            ClassCreator::NewInstanceFrom()), which constructs the
+            native once if the ClassCreator_Factory supports it.
+
+            If ClassCreator<T>::Instance() throws (e.g. when used from
+            another isolate), this throws a JS exception instead, and an
+            unmapped pointer stays owned by the caller.
         */
-		struct NativeToJSImpl
-		{
-			v8::Handle<v8::Value> operator()( NativeHandle n ) const
-			{
-				JSObjHandle const & rc( GetJSObject( n ) );
-
-				if( rc.IsEmpty() || !rc->IsObject() )
-				{
-					JSObjHandle toReturn =
-						v8::Persistent<v8::Object>::New(
-						ClassCreator<T>::Instance().NewInstance( 0, NULL ) );
-
-					auto ptr = static_cast<T*>( toReturn->GetPointerFromInternalField( ClassCreator_InternalFields<Type>::NativeIndex ) );
-
-					if( ptr )
-						delete ptr;
-
-					toReturn->SetPointerInInternalField( ClassCreator_InternalFields<Type>::NativeIndex, (void*)n );
-					Insert( toReturn, n );
-					return toReturn;
-				}
-				else
-				{
-					return rc;
-				}
-			}
-			v8::Handle<v8::Value> operator()( const Type& n ) const
-			{
-				// Create new object
-				v8::Handle<v8::Object>& toReturn = ClassCreator<T>::Instance().NewInstance( 0, NULL );
-				// Copy values from original to new
-				*static_cast<T*>( toReturn->GetPointerFromInternalField( ClassCreator_InternalFields<Type>::NativeIndex ) ) = n;
-				return toReturn;
-			}
-		};
-
-#if 0
-        //! Experimental
-        template <typename ParentType>
-        struct NativeToJSImpl_Subclass
+        struct NativeToJSImpl
         {
-            v8::Handle<v8::Value> operator()( Type const * n ) const
+            v8::Handle<v8::Value> operator()( NativeHandle n ) const
             {
-                typedef NativeToJSMap<T> BM;
-                v8::Handle<v8::Value> const & rc( BM::GetJSObject(n) );
-                if( rc.IsEmpty() )
+                JSObjHandle const & rc( GetJSObject( n ) );
+                if( !rc.IsEmpty() && rc->IsObject() ) return rc;
+                else if( !n ) return v8::Null();
+                v8::Handle<v8::Object> obj;
+                try
                 {
-                    typedef typename NativeToJSMap<ParentType>::NativeToJSImpl PI;
-                    return PI()(n);
-#if 0
-                    typedef typename TypeInfo<ParentType>::NativeHandle PH;
-                    rc = CastToJS<ParentType>(n);
-                    if( rc.IsEmpty() ) return v8::Null();
-                    else return rc;
-#endif
+                    obj = ClassCreator<T>::Instance().NewInstanceWrapping( const_cast<Type *>(n) );
                 }
-                else return rc;
+                catch( std::exception const & ex )
+                {
+                    return Toss( CastToJS(ex) );
+                }
+                if( obj.IsEmpty() ) return obj;
+                JSObjHandle const toReturn( JSObjHandle::New( obj ) );
+                Insert( toReturn, n );
+                return toReturn;
             }
             v8::Handle<v8::Value> operator()( Type const & n ) const
             {
-                return this->operator()( &n );
+                try
+                {
+                    return ClassCreator<T>::Instance().NewInstanceFrom( n );
+                }
+                catch( std::exception const & ex )
+                {
+                    return Toss( CastToJS(ex) );
+                }
+            }
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+            v8::Handle<v8::Value> operator()( Type && n ) const
+            {
+                try
+                {
+                    return ClassCreator<T>::Instance().NewInstanceFrom( std::move(n) );
+                }
+                catch( std::exception const & ex )
+                {
+                    return Toss( CastToJS(ex) );
+                }
             }
-        };
 #endif
+        };
     };
 
 } // namespaces
@@ -0,0 +1,275 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_STRUCT_DESCRIPTOR_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_STRUCT_DESCRIPTOR_HPP_INCLUDED 1
+/*
+  Conversion of plain native structs to and from plain JS objects,
+  driven by a compile-time list of the struct's members.
+
+  License: Dual MIT/Public Domain
+*/
+#include "detail/convert_core.hpp"
+#include <type_traits>
+
+namespace cvv8 {
+
+    /**
+        Describes one member variable of struct T, for use in a
+        StructDescriptor<T>::Fields list. PropertyType must be
+        convertible with CastToJS() and CastFromJS().
+    */
+    template <typename T, typename PropertyType, PropertyType T::*MemVar>
+    struct StructField
+    {
+        typedef T Type;
+        typedef PropertyType ValueType;
+        /** Sets dest[key] to CastToJS(src.*MemVar). */
+        static void ToJS( T const & src, v8::Handle<v8::Object> const & dest,
+                          v8::Handle<v8::String> const & key )
+        {
+            dest->Set( key, CastToJS( src.*MemVar ) );
+        }
+        /** Sets dest.*MemVar to CastFromJS<PropertyType>(src[key]). */
+        static void FromJS( v8::Handle<v8::Object> const & src,
+                            v8::Handle<v8::String> const & key, T & dest )
+        {
+            dest.*MemVar = CastFromJS<PropertyType>( src->Get( key ) );
+        }
+    };
+
+    /**
+        Describes the JS representation of struct T for StructTemplate
+        (and hence for NativeToJS_Struct and JSToNative_Struct). There
+        is no default implementation: clients specialize it with two
+        members, a typelist of StructField types (at least one) and a
+        function returning a reference to an array holding the JS
+        property name of each of them, in the same order. The array
+        size must match the number of fields, which is checked at
+        compile time:
+
+        @code
+        struct Point { int x; int y; std::string label; };
+
+        namespace cvv8 {
+            template <>
+            struct StructDescriptor<Point>
+            {
+                typedef CVV8_TYPELIST((
+                    StructField<Point, int, &Point::x>,
+                    StructField<Point, int, &Point::y>,
+                    StructField<Point, std::string, &Point::label>
+                )) Fields;
+                static char const * const (&FieldNames())[3]
+                {
+                    static char const * const names[] = { "x", "y", "label" };
+                    return names;
+                }
+            };
+            template <>
+            struct NativeToJS<Point> : NativeToJS_Struct<Point> {};
+            template <>
+            struct JSToNative<Point> : JSToNative_Struct<Point> {};
+        }
+        @endcode
+
+        Note that JSToNative_Struct converts by value. Bindings which
+        take a (Point const &) argument need a
+        JSToNative<Point const &> specialization which subclasses
+        JSToNative_Struct<Point> as well.
+    */
+    template <typename T>
+    struct StructDescriptor;
+
+#if !defined(DOXYGEN)
+namespace Detail {
+    /**
+       Applies StructField I through N-1 of the Fields typelist.
+       names holds the property name of each field.
+    */
+    template <typename T, typename Fields, int I = 0, int N = sl::Length<Fields>::Value>
+    struct StructFields
+    {
+        typedef typename sl::At<I, Fields>::Type Field;
+        typedef StructFields<T, Fields, I + 1, N> Next;
+        static void ToJS( T const & src, v8::Handle<v8::Object> const & dest,
+                          v8::Persistent<v8::String> const * names )
+        {
+            Field::ToJS( src, dest, names[I] );
+            Next::ToJS( src, dest, names );
+        }
+        static void FromJS( v8::Handle<v8::Object> const & src, T & dest,
+                            v8::Persistent<v8::String> const * names )
+        {
+            Field::FromJS( src, names[I], dest );
+            Next::FromJS( src, dest, names );
+        }
+    };
+    template <typename T, typename Fields, int N>
+    struct StructFields<T, Fields, N, N>
+    {
+        static void ToJS( T const &, v8::Handle<v8::Object> const &,
+                          v8::Persistent<v8::String> const * )
+        {}
+        static void FromJS( v8::Handle<v8::Object> const &, T &,
+                            v8::Persistent<v8::String> const * )
+        {}
+    };
+}
+#endif // DOXYGEN
+
+    /**
+        Converts T objects to and from JS objects as described by
+        StructDescriptor<T>.
+
+        The property names are created as JS symbols once, and the JS
+        objects are created from an ObjectTemplate, also created once,
+        which declares all of the properties in descriptor order. All
+        objects made by ToJS() therefore start out with the same
+        shape (hidden class) and filling them in only assigns
+        existing properties, instead of adding a new property, with a
+        newly created key string, per field and object.
+
+        The cached handles are created on first use and live for the
+        rest of the process. Like the ClassCreator templates, they
+        are not tied to a context, but they are tied to the v8
+        instance that was current when they were created.
+    */
+    template <typename T>
+    class StructTemplate
+    {
+    public:
+        typedef StructDescriptor<T> Descriptor;
+        typedef typename Descriptor::Fields Fields;
+        /** The number of fields. */
+        enum { FieldCount = sl::Length<Fields>::Value };
+    private:
+        static_assert( FieldCount > 0, "StructDescriptor<T>::Fields must not be empty." );
+        static_assert( std::extent< typename std::remove_reference< decltype( Descriptor::FieldNames() ) >::type >::value
+                       == static_cast<std::size_t>(FieldCount),
+                       "StructDescriptor<T>::FieldNames() must return a reference to an array "
+                       "with exactly one name per entry in Fields." );
+        typedef Detail::StructFields<T, Fields> Impl;
+        struct State
+        {
+            v8::Persistent<v8::ObjectTemplate> tmpl;
+            v8::Persistent<v8::String> names[FieldCount];
+            State()
+            {
+                v8::HandleScope hsc;
+                tmpl = v8::Persistent<v8::ObjectTemplate>::New( v8::ObjectTemplate::New() );
+                char const * const * n = Descriptor::FieldNames();
+                for( int i = 0; i < FieldCount; ++i )
+                {
+                    names[i] = v8::Persistent<v8::String>::New( v8::String::NewSymbol( n[i] ) );
+                    tmpl->Set( names[i], v8::Undefined() );
+                }
+            }
+        };
+        static State & state()
+        {
+            static State bob;
+            return bob;
+        }
+    public:
+        /**
+            Returns the template from which ToJS() creates objects. The
+            caller may add properties to it, but only before the first
+            call to ToJS() (or NewInstance()).
+        */
+        static v8::Handle<v8::ObjectTemplate> Template()
+        {
+            return state().tmpl;
+        }
+
+        /**
+            Returns the JS property name of field i, or an empty handle
+            if i is out of range.
+        */
+        static v8::Handle<v8::String> FieldName( int i )
+        {
+            return ((i < 0) || (i >= FieldCount))
+                ? v8::Handle<v8::String>()
+                : v8::Handle<v8::String>( state().names[i] );
+        }
+
+        /**
+            Returns a new, empty (all fields undefined) object from
+            Template().
+        */
+        static v8::Handle<v8::Object> NewInstance()
+        {
+            return state().tmpl->NewInstance();
+        }
+
+        /** Sets all fields of dest from src. */
+        static void Fill( T const & src, v8::Handle<v8::Object> const & dest )
+        {
+            Impl::ToJS( src, dest, state().names );
+        }
+
+        /**
+            Returns a new JS object holding all fields of src, or an
+            empty handle if creating it failed (e.g. because a JS
+            exception is propagating).
+        */
+        static v8::Handle<v8::Object> ToJS( T const & src )
+        {
+            State & s( state() );
+            v8::HandleScope hsc;
+            v8::Handle<v8::Object> obj( s.tmpl->NewInstance() );
+            if( obj.IsEmpty() ) return obj;
+            Impl::ToJS( src, obj, s.names );
+            return hsc.Close( obj );
+        }
+
+        /**
+            Sets all fields of dest from the corresponding properties
+            of src. Missing properties convert as undefined does.
+        */
+        static void FromJS( v8::Handle<v8::Object> const & src, T & dest )
+        {
+            Impl::FromJS( src, dest, state().names );
+        }
+    };
+
+    /**
+        A NativeToJS<T> implementation for structs described by
+        StructDescriptor<T>. See StructTemplate::ToJS().
+    */
+    template <typename T>
+    struct NativeToJS_Struct
+    {
+        v8::Handle<v8::Value> operator()( T const & v ) const
+        {
+            return StructTemplate<T>::ToJS( v );
+        }
+        /** Returns null if v is NULL, else (*this)(*v). */
+        v8::Handle<v8::Value> operator()( T const * v ) const
+        {
+            if( !v ) return v8::Null();
+            return StructTemplate<T>::ToJS( *v );
+        }
+    };
+
+    /**
+        A JSToNative<T> implementation for structs described by
+        StructDescriptor<T>. It converts by value: the result is a
+        value-initialized T (T()) filled from the JS object's
+        properties, or left as is if the value is not an object.
+    */
+    template <typename T>
+    struct JSToNative_Struct
+    {
+        typedef T ResultType;
+        ResultType operator()( v8::Handle<v8::Value> const & h ) const
+        {
+            T rc = T();
+            if( !h.IsEmpty() && h->IsObject() )
+            {
+                StructTemplate<T>::FromJS( v8::Handle<v8::Object>( v8::Object::Cast( *h ) ), rc );
+            }
+            return rc;
+        }
+    };
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_STRUCT_DESCRIPTOR_HPP_INCLUDED */
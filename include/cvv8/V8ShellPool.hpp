@@ -0,0 +1,432 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_V8SHELLPOOL_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_V8SHELLPOOL_HPP_INCLUDED 1
+/*
+  A pool of worker threads, each running its own v8 isolate, for
+  running independent scripts in parallel.
+
+  Requires C++11 threads (CVV8_CONFIG_HAS_STD_THREAD) and a v8 which
+  supports isolates (v8 3.6+, CVV8_CONFIG_HAS_ISOLATE_LOCKING).
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert.hpp"
+
+#if !CVV8_CONFIG_HAS_STD_THREAD
+#  error "V8ShellPool requires C++11 threads (CVV8_CONFIG_HAS_STD_THREAD)."
+#endif
+#if !CVV8_CONFIG_HAS_ISOLATE_LOCKING
+#  error "V8ShellPool requires CVV8_CONFIG_HAS_ISOLATE_LOCKING (v8 3.6 or later)."
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cvv8 {
+
+    /**
+       Runs JS code on a fixed set of worker threads, each of which owns
+       a separate v8 isolate, so that independent jobs can use all
+       cores of a machine, as opposed to V8Shell, which runs everything
+       in one context behind one v8::Locker.
+
+       Each worker's global object is set up by the SetupFunction given
+       to the constructor, which is called in each worker's isolate.
+       Since the isolates share nothing, values are passed in and out
+       as JSON text.
+
+       Submitted tasks are distributed round-robin to per-worker
+       queues. Each worker sleeps on its own condition variable, and
+       when a task lands in the queue of a busy worker, an idle one is
+       woken to steal it, so that a few long-running tasks do not hold
+       up the ones queued behind them.
+
+       By default each worker runs all of its tasks in one context, so
+       global variables which a task creates are still visible to later
+       tasks which happen to run on the same worker. Scripts must not
+       rely on that (or on its absence). Pass contextPerTask=true to
+       the constructor to run each task in a fresh context instead, at
+       the cost of creating a context and calling the SetupFunction
+       once per task.
+
+       @code
+       void setup( v8::Handle<v8::Object> global )
+       {
+           global->Set( v8::String::New("hash"),
+                        v8::FunctionTemplate::New( FunctionToInCa<unsigned (std::string const &), hash>::Call )->GetFunction() );
+       }
+       ...
+       V8ShellPool pool( setup, 32 );
+       std::future<std::string> a = pool.Submit( "1 + 2" ); // "3"
+       std::future<std::string> b = pool.Submit( "function(s){ return hash(s); }", "[\"abc\"]" );
+       std::cout << a.get() << ' ' << b.get() << '\n';
+       @endcode
+
+       What may be used in the workers' bindings:
+
+       - Function and method bindings (FunctionToInCa, FunctionToBatchInCa
+       and friends, including InCaProfiler and InCaAdaptiveUnlock, whose
+       statistics are guarded by mutexes), the conversions of
+       convert.hpp, and SymbolCache/CVV8_SYMBOL() (and so the char
+       const * overloads of ObjectPropSetter), which keeps one cache
+       per isolate.
+
+       - Not ClassCreator-bound classes. ClassCreator<T>::Instance()
+       holds templates of the isolate which first used it and throws
+       if it is used from another one. This rules out the add-ons
+       which bind classes (ByteArray, Socket, PathFinder, whio, jspdo,
+       expat, curl and the like). Bind such classes in the main
+       isolate only.
+
+       - Not StructTemplate (and so NativeToJS_Struct) or LazyBinding,
+       which keep v8 handles in process-wide statics without any
+       check.
+
+       The library must be built with CVV8_CONFIG_HAS_ISOLATE_LOCKING
+       enabled everywhere, so that UnlockV8 bindings unlock the
+       worker's own isolate, and so that SymbolCache is per-isolate.
+    */
+    class V8ShellPool
+    {
+    public:
+        /**
+           Sets up the bindings of a worker. It is called in the
+           worker's thread, with the worker's isolate locked and its
+           context entered, and must install the bindings into the
+           given global object. If it throws, the tasks which the
+           worker takes fail with that exception.
+        */
+        typedef void (*SetupFunction)( v8::Handle<v8::Object> global );
+
+    private:
+        struct Task
+        {
+            std::string source;
+            std::string args;
+            std::promise<std::string> result;
+            Task( std::string const & src, std::string const & a )
+                : source(src), args(a), result()
+            {}
+        };
+        typedef std::unique_ptr<Task> TaskPtr;
+        typedef std::unique_lock<std::mutex> Lock;
+
+        struct Worker
+        {
+            /** Guards all other members except thread. */
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::deque<TaskPtr> tasks;
+            /** True while the worker waits on wake. */
+            bool idle;
+            bool stop;
+            std::thread thread;
+            Worker() : mutex(), wake(), tasks(), idle(false), stop(false), thread() {}
+        };
+
+        SetupFunction setup;
+        bool const contextPerTask;
+        std::vector< std::unique_ptr<Worker> > workers;
+        std::atomic<std::size_t> next;
+
+        V8ShellPool( V8ShellPool const & );
+        V8ShellPool & operator=( V8ShellPool const & );
+
+        /**
+           Pops a task from w's queue, from the front if own is true,
+           else (stealing) from the back. Returns NULL if it is empty.
+        */
+        static TaskPtr pop( Worker & w, bool own )
+        {
+            Lock const lk( w.mutex );
+            if( w.tasks.empty() ) return TaskPtr();
+            TaskPtr t;
+            if( own )
+            {
+                t = std::move( w.tasks.front() );
+                w.tasks.pop_front();
+            }
+            else
+            {
+                t = std::move( w.tasks.back() );
+                w.tasks.pop_back();
+            }
+            return t;
+        }
+
+        /** Steals a task from any worker but self. */
+        TaskPtr steal( std::size_t self )
+        {
+            std::size_t const n = workers.size();
+            TaskPtr t;
+            for( std::size_t i = 1; !t && (i < n); ++i )
+            {
+                t = pop( *workers[(self + i) % n], false );
+            }
+            return t;
+        }
+
+        /**
+           Returns the next task for the given worker: the oldest one
+           from its own queue, else the newest one from another
+           worker's queue. Sleeps while there are none, and returns
+           NULL once the pool is stopping and no tasks are left.
+        */
+        TaskPtr take( std::size_t self )
+        {
+            Worker & w( *workers[self] );
+            for( ;; )
+            {
+                TaskPtr t( pop( w, true ) );
+                if( !t ) t = steal( self );
+                if( t ) return t;
+                /* Publish idle before the last scan, so that a task
+                   queued at a busy worker after it either shows up in
+                   the scan or makes Submit() wake us (see wakeIdle()). */
+                {
+                    Lock const lk( w.mutex );
+                    w.idle = true;
+                }
+                t = steal( self );
+                Lock lk( w.mutex );
+                if( t )
+                {
+                    w.idle = false;
+                    return t;
+                }
+                if( w.idle && w.tasks.empty() )
+                {
+                    if( w.stop )
+                    {
+                        w.idle = false;
+                        return TaskPtr();
+                    }
+                    while( w.idle && w.tasks.empty() && !w.stop ) w.wake.wait( lk );
+                }
+                w.idle = false;
+            }
+        }
+
+        /**
+           Wakes one idle worker other than skip, if any, so that it
+           steals a task from a busy one.
+        */
+        void wakeIdle( std::size_t skip )
+        {
+            for( std::size_t i = 0; i < workers.size(); ++i )
+            {
+                if( i == skip ) continue;
+                Worker & w( *workers[i] );
+                Lock const lk( w.mutex );
+                if( !w.idle ) continue;
+                /* Cleared here too, so that the next call picks
+                   another worker. */
+                w.idle = false;
+                w.wake.notify_one();
+                return;
+            }
+        }
+
+        static std::string exceptionText( v8::TryCatch const & tc )
+        {
+            v8::String::Utf8Value const msg( tc.Exception() );
+            return *msg ? std::string( *msg, msg.length() ) : std::string( "<unknown JS exception>" );
+        }
+
+        /**
+           Runs the task in the current context and returns its result
+           as JSON text. Throws std::runtime_error if the code throws.
+        */
+        static std::string runTask( Task const & t )
+        {
+            v8::HandleScope hsc;
+            v8::TryCatch tc;
+            v8::Handle<v8::Object> const global( v8::Context::GetCurrent()->Global() );
+            v8::Handle<v8::Object> const json( v8::Handle<v8::Object>::Cast( global->Get( v8::String::New( "JSON" ) ) ) );
+            v8::Handle<v8::Script> const script(
+                v8::Script::Compile( v8::String::New( t.args.empty() ? t.source.c_str() : ("(" + t.source + ")").c_str() ),
+                                     v8::String::New( "V8ShellPool" ) ) );
+            v8::Handle<v8::Value> rv;
+            if( !script.IsEmpty() ) rv = script->Run();
+            if( !rv.IsEmpty() && !t.args.empty() )
+            {
+                if( !rv->IsFunction() ) throw std::runtime_error( "V8ShellPool task source is not a function." );
+                v8::Handle<v8::Value> parseArgv[] = { v8::String::New( t.args.c_str(), static_cast<int>(t.args.size()) ) };
+                v8::Handle<v8::Function> const parse( v8::Handle<v8::Function>::Cast( json->Get( v8::String::New( "parse" ) ) ) );
+                v8::Handle<v8::Value> const args( parse->Call( json, 1, parseArgv ) );
+                if( !args.IsEmpty() )
+                {
+                    if( !args->IsArray() ) throw std::runtime_error( "V8ShellPool task arguments are not a JSON array." );
+                    v8::Handle<v8::Array> const ar( v8::Handle<v8::Array>::Cast( args ) );
+                    int const argc = static_cast<int>( ar->Length() );
+                    std::vector< v8::Handle<v8::Value> > argv( argc ? argc : 1 );
+                    for( int i = 0; i < argc; ++i ) argv[i] = ar->Get( static_cast<uint32_t>(i) );
+                    rv = v8::Handle<v8::Function>::Cast( rv )->Call( global, argc, &argv[0] );
+                }
+                else rv = v8::Handle<v8::Value>();
+            }
+            if( !rv.IsEmpty() )
+            {
+                v8::Handle<v8::Function> const stringify( v8::Handle<v8::Function>::Cast( json->Get( v8::String::New( "stringify" ) ) ) );
+                rv = stringify->Call( json, 1, &rv );
+            }
+            if( rv.IsEmpty() ) throw std::runtime_error( exceptionText( tc ) );
+            return rv->IsUndefined() ? std::string() : JSToStdString( rv );
+        }
+
+        /**
+           Creates a context, enters it and sets up its bindings. If
+           setup throws, the exception is stored in setupError.
+        */
+        struct WorkerContext
+        {
+            v8::Persistent<v8::Context> cx;
+            std::exception_ptr setupError;
+            explicit WorkerContext( SetupFunction setup )
+                : cx( v8::Context::New() ), setupError()
+            {
+                cx->Enter();
+                try
+                {
+                    v8::HandleScope hsc;
+                    if( setup ) setup( cx->Global() );
+                }
+                catch(...)
+                {
+                    setupError = std::current_exception();
+                }
+            }
+            ~WorkerContext()
+            {
+                cx->Exit();
+                cx.Dispose();
+            }
+        };
+
+        void runTasks( std::size_t self )
+        {
+            std::unique_ptr<WorkerContext> shared( contextPerTask ? 0 : new WorkerContext( setup ) );
+            while( TaskPtr t = take( self ) )
+            {
+                std::unique_ptr<WorkerContext> own( contextPerTask ? new WorkerContext( setup ) : 0 );
+                WorkerContext const & wc( own ? *own : *shared );
+                if( wc.setupError ) t->result.set_exception( wc.setupError );
+                else
+                {
+                    try
+                    {
+                        t->result.set_value( runTask( *t ) );
+                    }
+                    catch(...)
+                    {
+                        t->result.set_exception( std::current_exception() );
+                    }
+                }
+            }
+        }
+
+        void workerMain( std::size_t self )
+        {
+            v8::Isolate * const iso = v8::Isolate::New();
+            {
+                v8::Locker const lock( iso );
+                v8::Isolate::Scope const isc( iso );
+                {
+                    v8::HandleScope hsc;
+                    runTasks( self );
+                }
+                SymbolCache::Clear();
+            }
+            iso->Dispose();
+        }
+
+    public:
+        /**
+           Starts n worker threads (by default, one per hardware
+           thread), each of which creates its own isolate and calls
+           setup (if not NULL) to install its bindings. If
+           contextPerTask is true, each task runs in a new context,
+           set up anew, else each worker keeps one context for all of
+           its tasks.
+        */
+        explicit V8ShellPool( SetupFunction setup, unsigned n = 0, bool contextPerTask = false )
+            : setup(setup), contextPerTask(contextPerTask), workers(), next(0)
+        {
+            if( !n ) n = std::thread::hardware_concurrency();
+            if( !n ) n = 2;
+            workers.reserve( n );
+            for( unsigned i = 0; i < n; ++i ) workers.push_back( std::unique_ptr<Worker>( new Worker ) );
+            for( unsigned i = 0; i < n; ++i ) workers[i]->thread = std::thread( &V8ShellPool::workerMain, this, i );
+        }
+
+        /**
+           Runs all tasks which are still queued, then stops the
+           workers and destroys their isolates.
+        */
+        ~V8ShellPool()
+        {
+            for( std::size_t i = 0; i < workers.size(); ++i )
+            {
+                Worker & w( *workers[i] );
+                {
+                    Lock const lk( w.mutex );
+                    w.stop = true;
+                }
+                w.wake.notify_one();
+            }
+            for( std::size_t i = 0; i < workers.size(); ++i ) workers[i]->thread.join();
+        }
+
+        /** Returns the number of workers. */
+        std::size_t Size() const
+        {
+            return workers.size();
+        }
+
+        /**
+           Queues a task and returns the future result.
+
+           If args is empty, source is run as a script and the result
+           is its completion value. Otherwise args must be a JSON array
+           and source the source code of a function (e.g.
+           "function(a,b){ return a+b; }"), which is called with the
+           array's elements as arguments.
+
+           The result is the JSON.stringify()'d result value, or an
+           empty string if it is undefined (or a function). If the task
+           throws, the future holds a std::runtime_error with the
+           exception's string form.
+
+           This may be called from any thread.
+        */
+        std::future<std::string> Submit( std::string const & source,
+                                         std::string const & args = std::string() )
+        {
+            TaskPtr t( new Task( source, args ) );
+            std::future<std::string> rc( t->result.get_future() );
+            std::size_t const w = next++ % workers.size();
+            Worker & dest( *workers[w] );
+            bool wasIdle;
+            {
+                Lock const lk( dest.mutex );
+                if( dest.stop ) throw std::logic_error( "V8ShellPool::Submit() called on a stopping pool." );
+                dest.tasks.push_back( std::move( t ) );
+                wasIdle = dest.idle;
+            }
+            dest.wake.notify_one();
+            if( !wasIdle ) wakeIdle( w );
+            return rc;
+        }
+    };
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_V8SHELLPOOL_HPP_INCLUDED */
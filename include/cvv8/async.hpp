@@ -0,0 +1,633 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_ASYNC_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_ASYNC_HPP_INCLUDED 1
+/*
+  Asynchronous function bindings: natives which run on a pool of
+  worker threads while the script continues, and report back to a JS
+  callback.
+
+  Requires CVV8_CONFIG_HAS_STD_THREAD (AsyncQueue) and
+  CVV8_CONFIG_HAS_VARIADIC_TEMPLATES (the binding templates). Without
+  them this header declares nothing.
+
+  License: Dual MIT/Public Domain
+*/
+#include "invocable.hpp"
+
+#if CVV8_CONFIG_HAS_STD_THREAD
+#include <cstddef>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cvv8 {
+
+    /**
+       The process-wide queue and worker thread pool behind
+       FunctionToAsyncInCa and friends.
+
+       A Job is submitted from the v8 thread, its Run() function is
+       called from a worker thread (without the v8 lock), and its
+       Complete() function is called later from the v8 thread, by
+       RunCompletions(), which is how results get back to JS. Calling
+       RunCompletions() (or RunLoop()) regularly is the job of the
+       application's event loop. The shell-skel addon calls RunLoop()
+       after running its scripts.
+
+       If no workers are running (see StartWorkers() and
+       StartWorkersLazily()), queued jobs are run by
+       WaitForCompletion() on the calling thread, so they still
+       complete, just without overlapping anything.
+
+       Jobs still queued or uncompleted when the application shuts
+       down are leaked.
+    */
+    class AsyncQueue
+    {
+    public:
+        /**
+           Interface for queued jobs. Jobs are created with new and
+           deleted by the queue (on the v8 thread) after Complete().
+        */
+        class Job
+        {
+        public:
+            virtual ~Job() {}
+            /**
+               Does the native work. Called from a worker thread which
+               does not hold the v8 lock, so it must not touch any v8
+               API. It must not throw.
+            */
+            virtual void Run() = 0;
+            /**
+               Called from the v8 thread (inside the context the job
+               belongs to) after Run() has returned. Must return false
+               if it leaves a JS exception propagating, else true.
+            */
+            virtual bool Complete() = 0;
+        };
+
+    private:
+        typedef std::deque<Job *> QueueT;
+        typedef std::unique_lock<std::mutex> Lock;
+
+        struct State
+        {
+            std::mutex mutex;
+            /** Signaled when a job is queued or the workers must stop. */
+            std::condition_variable wake;
+            /** Signaled when a job has finished running. */
+            std::condition_variable done;
+            QueueT todo;
+            QueueT finished;
+            std::vector<std::thread> workers;
+            bool stopWorkers;
+            /** Number of jobs submitted but not yet completed. */
+            std::size_t pending;
+            /** Set by StartWorkersLazily(). */
+            bool lazyStart;
+            std::size_t lazyWorkers;
+            State() : mutex(), wake(), done(), todo(), finished(), workers(),
+                      stopWorkers(false), pending(0), lazyStart(false), lazyWorkers(0)
+            {}
+        };
+
+        static State & state()
+        {
+            static State bob;
+            return bob;
+        }
+
+        static void workerMain()
+        {
+            State & s( state() );
+            for( ;; )
+            {
+                Job * j;
+                {
+                    Lock lk( s.mutex );
+                    while( !s.stopWorkers && s.todo.empty() ) s.wake.wait( lk );
+                    if( s.todo.empty() ) return /* stopWorkers is set */;
+                    j = s.todo.front();
+                    s.todo.pop_front();
+                }
+                j->Run();
+                {
+                    Lock const lk( s.mutex );
+                    s.finished.push_back( j );
+                }
+                s.done.notify_all();
+            }
+        }
+
+        /**
+           Starts n (0=one per hardware thread) workers. The caller
+           must hold s.mutex, and no workers may be running.
+        */
+        static void startWorkers( State & s, std::size_t n )
+        {
+            if( !n ) n = std::thread::hardware_concurrency();
+            if( !n ) n = 2;
+            s.stopWorkers = false;
+            s.lazyStart = false;
+            for( std::size_t i = 0; i < n; ++i ) s.workers.push_back( std::thread( workerMain ) );
+        }
+
+        /**
+           Completes up to max (0=all) finished jobs. Sets ok to false
+           and stops if a job's Complete() fails.
+        */
+        static std::size_t runCompletions( std::size_t max, bool & ok )
+        {
+            State & s( state() );
+            QueueT batch;
+            {
+                Lock const lk( s.mutex );
+                for( std::size_t n = 0; !s.finished.empty() && (!max || (n < max)); ++n )
+                {
+                    batch.push_back( s.finished.front() );
+                    s.finished.pop_front();
+                }
+            }
+            std::size_t rc = 0;
+            ok = true;
+            while( ok && !batch.empty() )
+            {
+                Job * const j = batch.front();
+                batch.pop_front();
+                ok = j->Complete();
+                delete j;
+                ++rc;
+            }
+            Lock const lk( s.mutex );
+            s.pending -= rc;
+            /* Put back whatever a failed completion left unprocessed. */
+            s.finished.insert( s.finished.begin(), batch.begin(), batch.end() );
+            return rc;
+        }
+
+    public:
+        /**
+           Queues j for running on a worker thread, first starting the
+           workers if StartWorkersLazily() asked for that. Must be
+           called from the v8 thread. Ownership of j passes to the
+           queue.
+        */
+        static void Submit( Job * j )
+        {
+            if( !j ) return;
+            State & s( state() );
+            {
+                Lock const lk( s.mutex );
+                if( s.lazyStart && s.workers.empty() ) startWorkers( s, s.lazyWorkers );
+                s.todo.push_back( j );
+                ++s.pending;
+            }
+            s.wake.notify_one();
+        }
+
+        /**
+           Calls Complete() on up to max (0=all) jobs which have
+           finished running, oldest first, and returns how many were
+           completed. If a completion leaves a JS exception
+           propagating, this stops there and returns, leaving the
+           remaining jobs for the next call. Must be called from the
+           v8 thread, inside the jobs' context.
+        */
+        static std::size_t RunCompletions( std::size_t max = 0 )
+        {
+            bool ok;
+            return runCompletions( max, ok );
+        }
+
+        /** Returns the number of jobs submitted but not yet completed. */
+        static std::size_t Pending()
+        {
+            State & s( state() );
+            Lock const lk( s.mutex );
+            return s.pending;
+        }
+
+        /**
+           Blocks until at least one job is ready for RunCompletions().
+           Returns false, without blocking, if no jobs are pending.
+
+           If no worker threads are running, this runs the oldest
+           queued job on the calling thread instead of waiting. While
+           waiting, the v8 lock is released (if v8::Locker is in use)
+           so that other threads can use v8 in the meantime.
+        */
+        static bool WaitForCompletion()
+        {
+            State & s( state() );
+            Job * j = 0;
+            {
+                Lock const lk( s.mutex );
+                if( !s.finished.empty() ) return true;
+                else if( !s.pending ) return false;
+                else if( s.workers.empty() && !s.todo.empty() )
+                {
+                    j = s.todo.front();
+                    s.todo.pop_front();
+                }
+            }
+            if( j )
+            {
+                j->Run();
+                Lock const lk( s.mutex );
+                s.finished.push_back( j );
+                return true;
+            }
+            std::unique_ptr<v8::Unlocker> unlocker(
+#if CVV8_CONFIG_HAS_ISOLATE_LOCKING
+                v8::Locker::IsActive() ? new v8::Unlocker( v8::Isolate::GetCurrent() ) : 0 );
+#else
+                v8::Locker::IsActive() ? new v8::Unlocker : 0 );
+#endif
+            Lock lk( s.mutex );
+            while( s.finished.empty() && s.pending ) s.done.wait( lk );
+            return !s.finished.empty();
+        }
+
+        /**
+           Runs completions until no jobs are pending, waiting for
+           them as needed. Returns false if a completion left a JS
+           exception propagating (the caller should report it, e.g.
+           via a v8::TryCatch, and may call this again to continue),
+           else true. Must be called from the v8 thread, inside the
+           jobs' context.
+        */
+        static bool RunLoop()
+        {
+            bool ok = true;
+            while( ok && WaitForCompletion() ) runCompletions( 0, ok );
+            return ok;
+        }
+
+        /**
+           Starts n worker threads (by default, one per hardware
+           thread). Returns false if workers are already running.
+
+           StopWorkers() must be called before the application exits.
+        */
+        static bool StartWorkers( std::size_t n = 0 )
+        {
+            State & s( state() );
+            Lock const lk( s.mutex );
+            if( !s.workers.empty() ) return false;
+            startWorkers( s, n );
+            return true;
+        }
+
+        /**
+           Like StartWorkers(n), but defers starting the threads until
+           the next Submit(), so that applications which may, but often
+           do not, make asynchronous calls (e.g. shells) do not keep
+           idle threads around. Does nothing if workers are already
+           running.
+
+           StopWorkers() must be called before the application exits.
+        */
+        static void StartWorkersLazily( std::size_t n = 0 )
+        {
+            State & s( state() );
+            Lock const lk( s.mutex );
+            if( !s.workers.empty() ) return;
+            s.lazyStart = true;
+            s.lazyWorkers = n;
+        }
+
+        /**
+           Stops the threads started by StartWorkers() (or
+           StartWorkersLazily()), after they have run all jobs queued
+           so far. Their completions are still left for
+           RunCompletions(). Cancels a lazy start which has not
+           happened yet, and otherwise does nothing if no workers are
+           running.
+        */
+        static void StopWorkers()
+        {
+            State & s( state() );
+            std::vector<std::thread> workers;
+            {
+                Lock const lk( s.mutex );
+                s.lazyStart = false;
+                if( s.workers.empty() ) return;
+                s.stopWorkers = true;
+                workers.swap( s.workers );
+            }
+            s.wake.notify_all();
+            for( std::size_t i = 0; i < workers.size(); ++i ) workers[i].join();
+        }
+    };
+
+} // cvv8
+#endif /* CVV8_CONFIG_HAS_STD_THREAD */
+
+#if CVV8_CONFIG_HAS_STD_THREAD && CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+#include <type_traits>
+namespace cvv8 {
+
+#if !defined(DOXYGEN)
+namespace Detail {
+    /**
+       Holds the result of a native call of return type RV until
+       it can be converted to JS on the v8 thread.
+    */
+    template <typename RV>
+    struct AsyncResult
+    {
+        typedef typename std::remove_cv<typename std::remove_reference<RV>::type>::type ValueType;
+        std::unique_ptr<ValueType> value;
+        AsyncResult() : value() {}
+        template <typename CallT>
+        void Set( CallT & c )
+        {
+            value.reset( new ValueType( c.Invoke() ) );
+        }
+        v8::Handle<v8::Value> ToJS() const
+        {
+            return CastToJS( *value );
+        }
+    };
+    template <>
+    struct AsyncResult<void>
+    {
+        template <typename CallT>
+        void Set( CallT & c )
+        {
+            c.Invoke();
+        }
+        v8::Handle<v8::Value> ToJS() const
+        {
+            return v8::Undefined();
+        }
+    };
+
+    /**
+       The AsyncQueue::Job part common to all asynchronous calls:
+       keeps the JS arguments (and 'this') alive until the call has
+       completed, catches the native exceptions, and passes
+       (error, result) to the callback, with the original call's
+       'this' as the callback's 'this'.
+    */
+    class AsyncCallBase : public AsyncQueue::Job
+    {
+    private:
+        v8::Persistent<v8::Function> callback;
+        v8::Persistent<v8::Object> receiver;
+        std::vector< v8::Persistent<v8::Value> > keep;
+        std::string error;
+        bool failed;
+    protected:
+        /** Argument arity of argv is the callback. */
+        AsyncCallBase( v8::Arguments const & argv, int arity )
+            : callback( v8::Persistent<v8::Function>::New( v8::Handle<v8::Function>::Cast( argv[arity] ) ) ),
+              receiver( v8::Persistent<v8::Object>::New( argv.This() ) ),
+              keep(), error(), failed(false)
+        {
+            keep.reserve( static_cast<std::size_t>(arity) );
+            for( int i = 0; i < arity; ++i ) keep.push_back( v8::Persistent<v8::Value>::New( argv[i] ) );
+        }
+        /** Calls the native. Runs on a worker thread. */
+        virtual void invoke() = 0;
+        /** Returns the converted result. Runs on the v8 thread. */
+        virtual v8::Handle<v8::Value> result() = 0;
+    public:
+        virtual ~AsyncCallBase()
+        {
+            for( std::size_t i = 0; i < keep.size(); ++i ) keep[i].Dispose();
+            receiver.Dispose();
+            callback.Dispose();
+        }
+        virtual void Run()
+        {
+            try
+            {
+                this->invoke();
+            }
+            catch( std::exception const & ex )
+            {
+                failed = true;
+                error = ex.what();
+            }
+            catch(...)
+            {
+                failed = true;
+                error = "Asynchronous native call threw an unknown exception!";
+            }
+        }
+        virtual bool Complete()
+        {
+            v8::HandleScope hsc;
+            v8::Handle<v8::Value> av[2] = { v8::Null(), v8::Undefined() };
+            if( !failed )
+            {
+                try
+                {
+                    av[1] = this->result();
+                }
+                catch( std::exception const & ex )
+                {
+                    failed = true;
+                    error = ex.what();
+                }
+                catch(...)
+                {
+                    failed = true;
+                    error = "Converting an asynchronous call's result threw an unknown exception!";
+                }
+            }
+            if( failed )
+            {
+                av[0] = v8::Exception::Error( v8::String::New( error.c_str(), static_cast<int>(error.size()) ) );
+                av[1] = v8::Undefined();
+            }
+            return ! callback->Call( receiver, 2, av ).IsEmpty();
+        }
+    };
+
+    /** AsyncQueue::Job for FunctionToAsyncInCa. */
+    template <typename Sig, typename FunctionSignature<Sig>::FunctionType Func>
+    class AsyncFunctionCall : public AsyncCallBase
+    {
+    public:
+        typedef FunctionSignature<Sig> SignatureType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        enum { Arity = sl::Arity<SignatureType>::Value };
+    private:
+        typename ForwarderArgs<typename SignatureType::FunctionType>::Type args;
+        AsyncResult<ReturnType> rv;
+        virtual void invoke() { rv.Set( *this ); }
+        virtual v8::Handle<v8::Value> result() { return rv.ToJS(); }
+    public:
+        explicit AsyncFunctionCall( v8::Arguments const & argv )
+            : AsyncCallBase( argv, Arity ), args( argv ), rv()
+        {}
+        ReturnType Invoke()
+        {
+            return args.template CallFunction<ReturnType>( Func );
+        }
+    };
+
+    /**
+       AsyncQueue::Job for MethodToAsyncInCa. T may be const, in which
+       case Func is a const member function.
+    */
+    template <typename T, typename Sig, typename MethodSignature<T,Sig>::FunctionType Func>
+    class AsyncMethodCall : public AsyncCallBase
+    {
+    public:
+        typedef MethodSignature<T,Sig> SignatureType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        enum { Arity = sl::Arity<SignatureType>::Value };
+    private:
+        T & self;
+        typename ForwarderArgs<typename SignatureType::FunctionType>::Type args;
+        AsyncResult<ReturnType> rv;
+        virtual void invoke() { rv.Set( *this ); }
+        virtual v8::Handle<v8::Value> result() { return rv.ToJS(); }
+    public:
+        AsyncMethodCall( T & self_, v8::Arguments const & argv )
+            : AsyncCallBase( argv, Arity ), self( self_ ), args( argv ), rv()
+        {}
+        ReturnType Invoke()
+        {
+            return args.template CallMethod<ReturnType>( self, Func );
+        }
+    };
+
+    /**
+       Validates the trailing callback argument of an asynchronous
+       call with the given arity. Returns an empty handle if argv is
+       okay, else the result of Toss()ing an error.
+    */
+    inline v8::Handle<v8::Value> AsyncCheckArgs( v8::Arguments const & argv, int arity )
+    {
+        if( (argv.Length() == arity + 1) && argv[arity]->IsFunction() ) return v8::Handle<v8::Value>();
+        StringBuffer msg;
+        msg << "Asynchronous function expects " << arity
+            << " argument(s) followed by a callback function!";
+        return Toss( msg );
+    }
+}
+#endif // DOXYGEN
+
+    /**
+       A variant of FunctionToInCa which does not block the calling
+       script. The native function runs on an AsyncQueue worker
+       thread, and the script gets the result through a callback
+       passed as an extra, last, argument:
+
+       @code
+       // Native:
+       std::string fetch( std::string const & url );
+       // Binding:
+       v8::InvocationCallback cb =
+           FunctionToAsyncInCa< std::string (std::string const &), fetch >::Call;
+       // JS, where the binding is named fetch():
+       fetch( url, function(err, result){ ... } ); // returns undefined
+       @endcode
+
+       When called, the JS arguments are converted to native form
+       (and the JS values are kept alive) on the v8 thread, then the
+       call is queued with AsyncQueue::Submit() and the function
+       returns. When the queue completes the job (see
+       AsyncQueue::RunCompletions()), the callback is called with
+       (null, result), result being the CastToJS()'d return value
+       (undefined for void functions), or, if the native threw,
+       with (error, undefined), error being an Error holding the
+       exception's what() text. The callback's 'this' is the 'this'
+       of the original call.
+
+       Since the native code runs without the v8 lock, the signature
+       must pass SignatureIsUnlockable, exactly as for
+       FunctionToInCa's UnlockV8 option, else a compile-time error is
+       triggered. Argument values which refer to JS-bound natives
+       (e.g. bound class pointers) must not be destroyed by the
+       script (e.g. via ClassCreator::DestroyObject()) before the
+       callback has run.
+    */
+    template <typename Sig, typename FunctionSignature<Sig>::FunctionType Func>
+    struct FunctionToAsyncInCa : FunctionPtr<Sig, Func>, InCa
+    {
+    private:
+        typedef Detail::AsyncFunctionCall<Sig, Func> JobType;
+        typedef char AssertUnlockable[ SignatureIsUnlockable< FunctionSignature<Sig> >::Value ? 1 : -1 ]
+            /* If compiler errors led you here, the signature uses a type
+               which may only be used while holding the v8 lock. */
+            ;
+    public:
+        static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
+        {
+            v8::Handle<v8::Value> const err( Detail::AsyncCheckArgs( argv, JobType::Arity ) );
+            if( !err.IsEmpty() ) return err;
+            try
+            {
+                AsyncQueue::Submit( new JobType( argv ) );
+            }
+            catch( std::exception const & ex )
+            {
+                return Toss( CastToJS( ex ) );
+            }
+            return v8::Undefined();
+        }
+    };
+
+    /**
+       The member function counterpart of FunctionToAsyncInCa. If T
+       is const, Func must be a const member function (as for
+       MethodToInCa). The native 'this' is looked up with
+       CastFromJS<T>(argv.This()) on the v8 thread, and the JS 'this'
+       object is kept alive until the callback has run. The
+       unlockability check includes T, and the object must not be
+       used by other threads (or destroyed) while the call runs.
+
+       @code
+       v8::InvocationCallback cb =
+           MethodToAsyncInCa< Database, Rows (std::string const &), &Database::query >::Call;
+       @endcode
+    */
+    template <typename T, typename Sig, typename MethodSignature<T,Sig>::FunctionType Func>
+    struct MethodToAsyncInCa : MethodPtr<T, Sig, Func>, InCa
+    {
+    private:
+        typedef Detail::AsyncMethodCall<T, Sig, Func> JobType;
+        typedef typename TypeInfo<T>::Type Type;
+        typedef char AssertUnlockable[ SignatureIsUnlockable< MethodSignature<T,Sig> >::Value ? 1 : -1 ]
+            /* If compiler errors led you here, the signature uses a type
+               which may only be used while holding the v8 lock. */
+            ;
+    public:
+        static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
+        {
+            v8::Handle<v8::Value> const err( Detail::AsyncCheckArgs( argv, JobType::Arity ) );
+            if( !err.IsEmpty() ) return err;
+            Type * const self = CastFromJS<Type>( argv.This() );
+            if( !self ) return TossMissingThis<Type>();
+            try
+            {
+                AsyncQueue::Submit( new JobType( *self, argv ) );
+            }
+            catch( std::exception const & ex )
+            {
+                return Toss( CastToJS( ex ) );
+            }
+            return v8::Undefined();
+        }
+    };
+
+    /**
+       Equivalent to MethodToAsyncInCa<T const, Sig, Func>.
+    */
+    template <typename T, typename Sig, typename ConstMethodSignature<T,Sig>::FunctionType Func>
+    struct ConstMethodToAsyncInCa : MethodToAsyncInCa<T const, Sig, Func>
+    {};
+
+} // cvv8
+#endif /* CVV8_CONFIG_HAS_STD_THREAD && CVV8_CONFIG_HAS_VARIADIC_TEMPLATES */
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_ASYNC_HPP_INCLUDED */
@@ -0,0 +1,301 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_BATCH_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_BATCH_HPP_INCLUDED 1
+/*
+  "Call over batch" function bindings: one JS call runs a native
+  function over a whole array of argument sets.
+
+  Requires CVV8_CONFIG_HAS_VARIADIC_TEMPLATES. Without it this header
+  declares nothing.
+
+  License: Dual MIT/Public Domain
+*/
+#include "invocable.hpp"
+
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+#include <deque>
+#include <vector>
+#include <type_traits>
+
+namespace cvv8 {
+
+#if !defined(DOXYGEN)
+namespace Detail {
+    /**
+       ConvertedArgs source for the "array of tuples" form: argument
+       I of a call is tuple[I].
+    */
+    struct BatchTupleArgs
+    {
+        v8::Handle<v8::Object> tuple;
+        explicit BatchTupleArgs( v8::Handle<v8::Object> const & t ) : tuple(t) {}
+        v8::Handle<v8::Value> operator[]( int i ) const
+        {
+            return tuple->Get( static_cast<uint32_t>(i) );
+        }
+    };
+
+    /**
+       ConvertedArgs source for the "parallel arrays" form: argument
+       I of call number row is columns[I][row].
+    */
+    struct BatchColumnArgs
+    {
+        v8::Handle<v8::Object> const * columns;
+        uint32_t row;
+        BatchColumnArgs( v8::Handle<v8::Object> const * c, uint32_t r ) : columns(c), row(r) {}
+        v8::Handle<v8::Value> operator[]( int i ) const
+        {
+            return columns[i]->Get( row );
+        }
+    };
+
+    /**
+       A v8::HandleScope for converting the arguments of one batch
+       entry, so that a large batch does not pile up handles, or
+       nothing if Enabled is false, which it must be when the
+       converted arguments are themselves v8 handles (they have to
+       outlive the entry).
+    */
+    template <bool Enabled>
+    struct BatchRowScope
+    {
+        v8::HandleScope hsc;
+        BatchRowScope() : hsc() {}
+    };
+    template <>
+    struct BatchRowScope<false>
+    {
+        BatchRowScope() {}
+    };
+
+    /**
+       Stores the results of a batch of native calls returning RV
+       until they are converted to JS. Values are copied, references
+       are stored as pointers, so that CastToJS() sees the original
+       objects.
+    */
+    template <typename RV>
+    struct BatchResults
+    {
+        typedef typename std::remove_cv<RV>::type ValueType;
+        std::vector<ValueType> values;
+        void Reserve( std::size_t n ) { values.reserve( n ); }
+        void Add( RV v ) { values.push_back( v ); }
+        v8::Handle<v8::Value> ToJS( std::size_t i ) const { return CastToJS( values[i] ); }
+    };
+    template <typename RV>
+    struct BatchResults<RV &>
+    {
+        std::vector<RV *> values;
+        void Reserve( std::size_t n ) { values.reserve( n ); }
+        void Add( RV & v ) { values.push_back( &v ); }
+        v8::Handle<v8::Value> ToJS( std::size_t i ) const { return CastToJS( *values[i] ); }
+    };
+
+    /**
+       Runs Func over all of argSets (the converted arguments of each
+       call) and returns an array of the results, or an empty handle
+       if a JS exception is pending.
+    */
+    template <typename Sig, typename FunctionSignature<Sig>::FunctionType Func,
+              bool UnlockV8, typename RV = typename FunctionSignature<Sig>::ReturnType>
+    struct BatchRunner
+    {
+        template <typename ArgsList>
+        static v8::Handle<v8::Value> Run( ArgsList & argSets )
+        {
+            v8::HandleScope hsc;
+            std::size_t const n = argSets.size();
+            BatchResults<RV> results;
+            results.Reserve( n );
+            {
+                V8Unlocker<UnlockV8> const unlocker( Func );
+                typename ArgsList::iterator it = argSets.begin();
+                for( ; argSets.end() != it; ++it )
+                {
+                    results.Add( it->template CallFunction<RV>( Func ) );
+                }
+            }
+            v8::Handle<v8::Array> rc( v8::Array::New( static_cast<int>(n) ) );
+            for( std::size_t i = 0; i < n; ++i )
+            {
+                v8::HandleScope row;
+                rc->Set( static_cast<uint32_t>(i), results.ToJS( i ) );
+            }
+            return hsc.Close( rc );
+        }
+    };
+    template <typename Sig, typename FunctionSignature<Sig>::FunctionType Func, bool UnlockV8>
+    struct BatchRunner<Sig, Func, UnlockV8, void>
+    {
+        template <typename ArgsList>
+        static v8::Handle<v8::Value> Run( ArgsList & argSets )
+        {
+            V8Unlocker<UnlockV8> const unlocker( Func );
+            typename ArgsList::iterator it = argSets.begin();
+            for( ; argSets.end() != it; ++it )
+            {
+                it->template CallFunction<void>( Func );
+            }
+            return v8::Undefined();
+        }
+    };
+}
+#endif // DOXYGEN
+
+    /**
+       An InCa which calls Func once for each of a batch of argument
+       sets, for natives which are so cheap that calling them once per
+       JS call is dominated by the binding overhead (geometry and
+       hashing helpers and the like).
+
+       It accepts either form of batch:
+
+       - An array of argument arrays ("tuples"), one per call:
+         f([[a1,b1], [a2,b2], ...]). This form is used when Func takes
+         more than one argument and exactly one JS argument is passed.
+
+       - One array per parameter ("parallel arrays"), all of the same
+         length: f([a1,a2,...], [b1,b2,...]). For single-argument
+         natives this is the only form: f([a1,a2,...]).
+
+       It returns an array with the CastToJS()'d result of each call,
+       in order, or undefined if Func returns void.
+
+       All arguments of all calls are converted first (each set in
+       its own v8::HandleScope, unless Func takes v8 handles), then
+       Func is called for each set in a plain C++ loop, and then all
+       results are converted, so the native calls are not interleaved
+       with v8 API calls. If UnlockV8 is true (the default when the signature
+       allows it), v8 is unlocked (if v8::Locker is in use) for the
+       duration of that loop only.
+
+       If any native call throws, the whole call fails with a JS
+       exception and no results are returned. Non-array arguments,
+       tuples of the wrong length and parallel arrays of different
+       lengths are likewise reported as JS exceptions.
+
+       Example:
+
+       @code
+       double hypot2( double x, double y ) { return x*x + y*y; }
+       v8::InvocationCallback cb =
+           FunctionToBatchInCa< double (double, double), hypot2 >::Call;
+       // JS: hypot2s([[3,4],[6,8]]) or hypot2s([3,6],[4,8]) => [25,100]
+       @endcode
+
+       Func must take at least one argument, and it must not take
+       v8::Arguments.
+    */
+    template <typename Sig,
+              typename FunctionSignature<Sig>::FunctionType Func,
+              bool UnlockV8 = SignatureIsUnlockable< FunctionSignature<Sig> >::Value >
+    struct FunctionToBatchInCa : FunctionPtr<Sig, Func>, InCa
+    {
+        typedef FunctionSignature<Sig> SignatureType;
+        typedef typename SignatureType::FunctionType FunctionType;
+        /** The number of arguments Func takes. */
+        enum { Arity = sl::Arity<SignatureType>::Value };
+    private:
+        typedef typename Detail::ForwarderArgs<FunctionType>::Type ArgsType;
+        /** std::deque because ArgsType must not be moved once built. */
+        typedef std::deque<ArgsType> ArgsList;
+        typedef Detail::BatchRunner<Sig, Func, UnlockV8> Runner;
+        /** Per-entry HandleScopes are only safe if no argument is a handle. */
+        typedef Detail::BatchRowScope< TypeListIsUnlockable<SignatureType>::Value > RowScope;
+        static_assert( !sl::IsInCaLike<SignatureType>::Value,
+                       "FunctionToBatchInCa cannot bind functions taking v8::Arguments." );
+        static_assert( sl::IsInCaLike<SignatureType>::Value || (Arity > 0),
+                       "FunctionToBatchInCa requires a function taking at least one argument." );
+        typedef char AssertCanEnableUnlock[ !UnlockV8 ? 1 : (SignatureIsUnlockable< SignatureType >::Value ? 1 : -1) ];
+
+        static bool isArray( v8::Handle<v8::Value> const & v )
+        {
+            return !v.IsEmpty() && v->IsArray();
+        }
+
+        static v8::Handle<v8::Value> callTuples( v8::Handle<v8::Array> const & tuples )
+        {
+            uint32_t const n = tuples->Length();
+            ArgsList argSets;
+            for( uint32_t i = 0; i < n; ++i )
+            {
+                bool ok;
+                {
+                    RowScope const row;
+                    v8::Handle<v8::Value> const t( tuples->Get( i ) );
+                    ok = isArray( t ) && (v8::Array::Cast( *t )->Length() == static_cast<uint32_t>(Arity));
+                    if( ok ) argSets.emplace_back( Detail::BatchTupleArgs( v8::Handle<v8::Object>::Cast( t ) ) );
+                }
+                if( !ok )
+                {
+                    StringBuffer msg;
+                    msg << "Batch entry #" << i << " is not an array of "
+                        << static_cast<int>(Arity) << " argument(s)!";
+                    return Toss( msg );
+                }
+            }
+            return Runner::Run( argSets );
+        }
+
+        static v8::Handle<v8::Value> callColumns( v8::Arguments const & argv )
+        {
+            v8::Handle<v8::Object> cols[Arity];
+            uint32_t n = 0;
+            for( int i = 0; i < Arity; ++i )
+            {
+                if( !isArray( argv[i] ) )
+                {
+                    StringBuffer msg;
+                    msg << "Batch argument #" << i << " is not an array!";
+                    return Toss( msg );
+                }
+                v8::Handle<v8::Array> const col( v8::Handle<v8::Array>::Cast( argv[i] ) );
+                uint32_t const len = col->Length();
+                if( !i ) n = len;
+                else if( len != n ) return Toss( "Batch argument arrays must all have the same length!" );
+                cols[i] = col;
+            }
+            ArgsList argSets;
+            for( uint32_t r = 0; r < n; ++r )
+            {
+                RowScope const row;
+                argSets.emplace_back( Detail::BatchColumnArgs( cols, r ) );
+            }
+            return Runner::Run( argSets );
+        }
+
+    public:
+        static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
+        {
+            try
+            {
+                if( (Arity > 1) && (1 == argv.Length()) && isArray( argv[0] ) )
+                {
+                    return callTuples( v8::Handle<v8::Array>::Cast( argv[0] ) );
+                }
+                else if( argv.Length() == Arity )
+                {
+                    return callColumns( argv );
+                }
+                StringBuffer msg;
+                msg << "Batch call expects " << static_cast<int>(Arity)
+                    << " argument array(s)"
+                    << ((Arity > 1) ? " or one array of argument arrays!" : "!");
+                return Toss( msg );
+            }
+            catch( std::exception const & ex )
+            {
+                return Toss( CastToJS( ex ) );
+            }
+            catch(...)
+            {
+                return Toss( "Unknown native exception thrown!" );
+            }
+        }
+    };
+
+} // cvv8
+#endif /* CVV8_CONFIG_HAS_VARIADIC_TEMPLATES */
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_BATCH_HPP_INCLUDED */
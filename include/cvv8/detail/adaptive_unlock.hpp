@@ -0,0 +1,138 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_ADAPTIVE_UNLOCK_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_ADAPTIVE_UNLOCK_HPP_INCLUDED 1
+/*
+  Settings and per-call state for adaptive unlocking, which unlocks
+  v8 only around native calls which have historically been slow. The
+  InCa decorator which does it, InCaAdaptiveUnlock, lives in
+  invocable_core.hpp.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include "wall_clock.hpp"
+
+namespace cvv8 {
+
+#if !defined(DOXYGEN)
+namespace Detail {
+    /** The AdaptiveUnlock thresholds. */
+    struct AdaptiveUnlockSettings
+    {
+        double unlockAboveUs;
+        double lockBelowUs;
+        static AdaptiveUnlockSettings & Instance()
+        {
+            static AdaptiveUnlockSettings bob = { 20.0, 5.0 };
+            return bob;
+        }
+    };
+
+    /** Returns the current time in microseconds, from an arbitrary base. */
+    inline double AdaptiveUnlockNowUs()
+    {
+        return WallClockUs();
+    }
+
+    /**
+       The address of Tag identifies the function (pointer) type F in
+       AdaptiveUnlockFrame.
+    */
+    template <typename F>
+    struct AdaptiveUnlockFuncType
+    {
+        static char Tag;
+    };
+    template <typename F>
+    char AdaptiveUnlockFuncType<F>::Tag = 0;
+
+    /**
+       Per-call state of the innermost active InCaAdaptiveUnlock call
+       on the current thread. It is claimed (setting used) by the
+       V8Unlocker<true> of the bound native function itself, i.e. the
+       one created for func, of the type identified by funcType. Other
+       unlockers, e.g. those of bindings called while converting the
+       arguments, leave it alone. The claiming unlocker unlocks only
+       if unlock is true, and, if measure is true, stores the
+       duration of the native call in bodyUs.
+    */
+    struct AdaptiveUnlockFrame
+    {
+        AdaptiveUnlockFrame * prev;
+        char const * funcType;
+        void const * func;
+        bool unlock;
+        bool measure;
+        bool used;
+        /** Negative until measured. */
+        double bodyUs;
+        static AdaptiveUnlockFrame *& Current()
+        {
+            static CVV8_THREAD_LOCAL AdaptiveUnlockFrame * cur = 0;
+            return cur;
+        }
+        /**
+           Returns the current frame, after claiming it, if it is not
+           yet claimed and belongs to the native function func, else
+           NULL.
+        */
+        template <typename F>
+        static AdaptiveUnlockFrame * Claim( F const & func )
+        {
+            AdaptiveUnlockFrame * const f = Current();
+            if( !f || f->used
+                || (f->funcType != &AdaptiveUnlockFuncType<F>::Tag)
+                || !(*static_cast<F const *>( f->func ) == func) ) return 0;
+            f->used = true;
+            return f;
+        }
+    };
+}
+#endif /* DOXYGEN */
+
+    /**
+       The process-wide settings of InCaAdaptiveUnlock.
+
+       A binding switches from unlocking to not unlocking when the
+       moving average of its native call durations drops below
+       LockBelowUs(), and back when it rises above UnlockAboveUs().
+       The gap between the two keeps bindings whose durations hover
+       around a single threshold from flipping back and forth.
+
+       The defaults are 20us and 5us. Change them, if needed, before
+       any adaptive bindings are called, as they are read without
+       synchronization.
+    */
+    struct AdaptiveUnlock
+    {
+        /**
+           While a binding is not unlocking, only one call in
+           SampleInterval is timed, to keep the clock reads off the
+           fast path. Calls which unlock are always timed.
+        */
+        enum { SampleInterval = 16 };
+
+        /**
+           Sets both thresholds, in microseconds. lockBelowUs is
+           clamped to unlockAboveUs.
+        */
+        static void SetThresholds( double unlockAboveUs, double lockBelowUs )
+        {
+            Detail::AdaptiveUnlockSettings & s( Detail::AdaptiveUnlockSettings::Instance() );
+            s.unlockAboveUs = unlockAboveUs;
+            s.lockBelowUs = (lockBelowUs > unlockAboveUs) ? unlockAboveUs : lockBelowUs;
+        }
+        /** Returns the average duration above which bindings unlock. */
+        static double UnlockAboveUs()
+        {
+            return Detail::AdaptiveUnlockSettings::Instance().unlockAboveUs;
+        }
+        /** Returns the average duration below which bindings stop unlocking. */
+        static double LockBelowUs()
+        {
+            return Detail::AdaptiveUnlockSettings::Instance().lockBelowUs;
+        }
+    };
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_ADAPTIVE_UNLOCK_HPP_INCLUDED */
@@ -0,0 +1,290 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_CLASS_HIERARCHY_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_CLASS_HIERARCHY_HPP_INCLUDED 1
+/*
+  A runtime registry of the inheritance relationships between bound
+  native types, used for JS-to-native upcasts and for finding the JS
+  object of a subclass instance through a parent-typed binding.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include "ptr_hash_map.hpp"
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cvv8 {
+
+    template <typename T> struct ClassCreator_TypeID;
+    template <typename T> struct NativeToJSMap;
+
+    /**
+       Records which bound native types inherit which others, so that
+       a native bound as a subclass can be converted to any of its
+       registered ancestors without dynamic_cast and without RTTI.
+
+       Each registered class gets a small integer index and a table,
+       indexed by class index, holding the pointer adjustment to each
+       of its ancestors (direct or indirect). The tables are completed
+       at registration time, so an upcast is one hash table lookup
+       (from the type ID stored in the JS object to its class) plus
+       one array lookup and pointer adjustment.
+
+       Classes are identified by ClassCreator_TypeID<T>::Value.
+       ClassCreator<T>::Inherit<ParentType>() calls Register<T,ParentType>()
+       if T natively inherits ParentType (see IsNativeBase), so types
+       bound with ClassCreator normally need not call it directly. Two
+       features build on the registry:
+
+       - JSToNative_ClassCreator<ParentType> accepts JS objects
+       holding a registered subclass of ParentType (if the type ID is
+       stored, i.e. ClassCreator_InternalFields<T>::TypeIDIndex is not
+       negative), and returns the correctly adjusted ParentType
+       pointer.
+
+       - NativeToJSMap<T>::Insert() also maps the object in the
+       NativeToJSMap of each of T's registered ancestors, so
+       CastToJS<ParentType>() on a pointer to a bound subclass
+       instance finds the subclass' JS object instead of creating a
+       new ParentType wrapper.
+
+       Limitations:
+
+       - Only public, non-virtual inheritance is supported. Registering
+       anything else triggers a compile-time error (ClassCreator's
+       Inherit() instead skips the registration for such types).
+
+       - If a subclass shares its parent's type ID (by subclassing
+       ClassCreator_TypeID<ParentType>), the ID identifies the parent,
+       and such objects are treated as parent objects with no pointer
+       adjustment, as they were before this registry existed.
+
+       - If a class reaches an ancestor through more than one path
+       (non-virtual diamond inheritance), the path registered first
+       is used.
+
+       - Mappings made by NativeToJSMap before a relationship was
+       registered are not retroactively copied to the ancestors'
+       maps. Bind classes before creating instances of them.
+
+       All functions require that the caller hold the v8 lock (or
+       otherwise serialize access).
+    */
+    class ClassHierarchy
+    {
+    public:
+        /**
+           The type of the function NativeToJSMap<T> uses to map or
+           unmap a native in one ancestor class' map. If jself is NULL
+           the mapping for native is removed, else native is mapped
+           to *jself.
+        */
+        typedef void (*MirrorFunc)( void const * native,
+                                    v8::Persistent<v8::Object> const * jself );
+    private:
+        struct ClassInfo
+        {
+            void const * typeID;
+            std::size_t index;
+            /** Pointer adjustment to each ancestor, indexed by class
+                index, or NotABase. */
+            std::vector<std::ptrdiff_t> offsets;
+            /** The indexes of all ancestors, in registration order. */
+            std::vector<std::size_t> ancestors;
+            /** Set when this class is registered as a parent. */
+            MirrorFunc mirror;
+            ClassInfo( void const * tid, std::size_t i )
+                : typeID(tid), index(i), offsets(), ancestors(), mirror(0)
+            {}
+            bool derivesFrom( std::size_t i ) const
+            {
+                return (i < offsets.size()) && (NotABase() != offsets[i]);
+            }
+            void addAncestor( std::size_t i, std::ptrdiff_t off )
+            {
+                if( (i == index) || derivesFrom(i) ) return;
+                if( offsets.size() <= i ) offsets.resize( i + 1, NotABase() );
+                offsets[i] = off;
+                ancestors.push_back( i );
+            }
+        };
+
+        struct State
+        {
+            /** A deque, so that ClassInfo references stay valid. */
+            std::deque<ClassInfo> classes;
+            Detail::PtrHashMap<ClassInfo *> byTypeID;
+            State() : classes(), byTypeID() {}
+        };
+
+        static State & state()
+        {
+            static State bob;
+            return bob;
+        }
+
+        static std::ptrdiff_t NotABase()
+        {
+            return (std::numeric_limits<std::ptrdiff_t>::min)();
+        }
+
+        /** Returns T's entry, or NULL if T has not been registered. */
+        template <typename T>
+        static ClassInfo *& infoOf()
+        {
+            static ClassInfo * bob = 0;
+            return bob;
+        }
+
+        /** Returns T's entry, creating it if needed. */
+        template <typename T>
+        static ClassInfo & add()
+        {
+            ClassInfo *& ci( infoOf<T>() );
+            if( !ci )
+            {
+                State & s( state() );
+                void const * const tid = ClassCreator_TypeID<T>::Value;
+                s.classes.push_back( ClassInfo( tid, s.classes.size() ) );
+                ci = &s.classes.back();
+                if( tid && !s.byTypeID.Find( tid ) ) s.byTypeID.Insert( tid, ci );
+            }
+            return *ci;
+        }
+
+        /**
+           Returns the distance, in bytes, from the start of a T to its
+           ParentType subobject. For a non-virtual base this is a
+           compile-time constant, so it is computed on (unconstructed)
+           storage for a T, which the language allows converting to a
+           pointer to a non-virtual base.
+        */
+        template <typename T, typename ParentType>
+        static std::ptrdiff_t baseOffset()
+        {
+            typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type buf;
+            T * const t = static_cast<T *>( static_cast<void *>( &buf ) );
+            ParentType * const p = t;
+            return reinterpret_cast<char const *>( p )
+                 - reinterpret_cast<char const *>( t );
+        }
+
+        /** SFINAE helper for IsNativeBase. */
+        template <typename T, typename ParentType>
+        static char canDowncast( decltype( static_cast<T *>( std::declval<ParentType *>() ) ) );
+        template <typename T, typename ParentType>
+        static long canDowncast( ... );
+
+    public:
+        /**
+           Value is true if ParentType is a public, non-virtual and
+           unambiguous base class of T, i.e. if Register<T,ParentType>()
+           may be used.
+        */
+        template <typename T, typename ParentType>
+        struct IsNativeBase : tmp::BoolVal<
+            std::is_base_of< typename TypeInfo<ParentType>::Type, typename TypeInfo<T>::Type >::value
+            && (1 == sizeof( canDowncast< typename TypeInfo<T>::Type,
+                                          typename TypeInfo<ParentType>::Type >( 0 ) ))
+            >
+        {};
+
+        /**
+           Registers T as a subclass of ParentType. Calling it more
+           than once for the same pair is harmless. The parent's own
+           registered ancestors become T's ancestors (and those of any
+           already-registered subclasses of T) as well.
+
+           ParentType must be a public, non-virtual base of T, else a
+           compile-time error is triggered.
+        */
+        template <typename T, typename ParentType>
+        static void Register()
+        {
+            typedef typename TypeInfo<T>::Type TT;
+            typedef typename TypeInfo<ParentType>::Type PT;
+            static_assert( IsNativeBase<T, ParentType>::Value,
+                           "ClassHierarchy::Register<T,ParentType>() requires that T publicly and non-virtually inherit ParentType." );
+            ClassInfo & p( add<PT>() );
+            ClassInfo & t( add<TT>() );
+            p.mirror = &NativeToJSMap<PT>::MirrorMapping;
+            std::ptrdiff_t const off = baseOffset<TT,PT>();
+            State & s( state() );
+            for( std::size_t i = 0; i < s.classes.size(); ++i )
+            {
+                ClassInfo & x( s.classes[i] );
+                if( (&x != &t) && !x.derivesFrom( t.index ) ) continue;
+                std::ptrdiff_t const toP = ((&x == &t) ? 0 : x.offsets[t.index]) + off;
+                x.addAncestor( p.index, toP );
+                for( std::size_t a = 0; a < p.ancestors.size(); ++a )
+                {
+                    std::size_t const ai = p.ancestors[a];
+                    x.addAncestor( ai, toP + p.offsets[ai] );
+                }
+            }
+        }
+
+        /**
+           If typeID is the type ID of a class registered as a
+           (direct or indirect) subclass of T, and native points to an
+           instance of that class, returns native adjusted to point to
+           its T part. Returns native if typeID is T's own ID, and NULL
+           in all other cases.
+
+           This has the signature of Detail::InternalFieldsLookup's
+           NativeUpcast function.
+        */
+        template <typename T>
+        static void * Upcast( void const * typeID, void * native )
+        {
+            ClassInfo const * const to = infoOf<typename TypeInfo<T>::Type>();
+            if( !to || !native || !typeID ) return 0;
+            ClassInfo * const * from = state().byTypeID.Find( typeID );
+            if( !from ) return 0;
+            else if( *from == to ) return native;
+            else if( !(*from)->derivesFrom( to->index ) ) return 0;
+            else return static_cast<char *>(native) + (*from)->offsets[to->index];
+        }
+
+        /**
+           Passes native, adjusted for each of T's registered
+           ancestors, to the ancestor's MirrorFunc, if it has one.
+           Used by NativeToJSMap<T> to keep its ancestors' maps in
+           sync with its own.
+        */
+        template <typename T>
+        static void Mirror( void const * native, v8::Persistent<v8::Object> const * jself )
+        {
+            ClassInfo const * const ci = infoOf<typename TypeInfo<T>::Type>();
+            if( !ci || !native ) return;
+            State & s( state() );
+            for( std::size_t a = 0; a < ci->ancestors.size(); ++a )
+            {
+                std::size_t const ai = ci->ancestors[a];
+                ClassInfo const & anc( s.classes[ai] );
+                if( anc.mirror )
+                {
+                    anc.mirror( static_cast<char const *>(native) + ci->offsets[ai], jself );
+                }
+            }
+        }
+
+        /**
+           Returns true if Register() has made T a (direct or
+           indirect) subclass of ParentType.
+        */
+        template <typename T, typename ParentType>
+        static bool IsSubclass()
+        {
+            ClassInfo const * const t = infoOf<typename TypeInfo<T>::Type>();
+            ClassInfo const * const p = infoOf<typename TypeInfo<ParentType>::Type>();
+            return t && p && t->derivesFrom( p->index );
+        }
+    };
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_CLASS_HIERARCHY_HPP_INCLUDED */
@@ -0,0 +1,268 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_CLASS_STATS_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_CLASS_STATS_HPP_INCLUDED 1
+/*
+  Per-class instance statistics for ClassCreator-bound types,
+  compiled in only if CVV8_CONFIG_ENABLE_CLASS_STATS is true.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include "ptr_hash_map.hpp"
+#include "stats_mutex.hpp"
+#include <cstddef>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if CVV8_CONFIG_ENABLE_CLASS_STATS
+#  include "wall_clock.hpp"
+#endif
+
+namespace cvv8 {
+
+    /**
+       Instance statistics for one ClassCreator-bound class. See
+       ClassStats.
+    */
+    struct ClassStatsRecord
+    {
+        /** The number of buckets in AgeAtDestruction. */
+        enum { AgeBuckets = 7 };
+        /** The class' name (TypeName<T>::Value). */
+        char const * Name;
+        /** Number of currently live (wrapped) instances. */
+        std::size_t Live;
+        /** Total number of instances created. */
+        std::size_t Created;
+        /** Total number of instances destroyed (Explicit + GC). */
+        std::size_t Destroyed;
+        /** Instances destroyed via ClassCreator<T>::DestroyObject(). */
+        std::size_t DestroyedExplicitly;
+        /** Instances destroyed by the garbage collector. */
+        std::size_t DestroyedByGC;
+        /**
+           Histogram of instance lifetimes, measured from creation to
+           destruction. Bucket i counts lifetimes shorter than 10^i
+           milliseconds (and at least 10^(i-1) ms, for i>0), except
+           for the last one, which counts all longer lifetimes. See
+           ClassStats::AgeBucketLabel().
+        */
+        std::size_t AgeAtDestruction[AgeBuckets];
+        ClassStatsRecord()
+            : Name(0), Live(0), Created(0), Destroyed(0),
+              DestroyedExplicitly(0), DestroyedByGC(0)
+        {
+            for( int i = 0; i < AgeBuckets; ++i ) AgeAtDestruction[i] = 0;
+        }
+    };
+
+    /**
+       The registry of the instance statistics of all classes bound
+       with ClassCreator, in the order their ClassCreator instances
+       were created.
+
+       The statistics are only collected if the library is compiled
+       with CVV8_CONFIG_ENABLE_CLASS_STATS set to a true value.
+       Otherwise the counting code is compiled out of ClassCreator
+       completely, no classes are registered, and the functions
+       report nothing.
+
+       SetupStatsBindings() (in shell_stats.hpp) makes these available
+       to JS code when they are enabled.
+
+       Mutex(), Records() and Stats() come from
+       Detail::StatsRegistry.
+    */
+    class ClassStats : public Detail::StatsRegistry<ClassStatsRecord>
+    {
+    public:
+        /** True if the statistics are compiled in. */
+        enum { Enabled = CVV8_CONFIG_ENABLE_CLASS_STATS };
+
+        /**
+           Returns a short label for ClassStatsRecord::AgeAtDestruction
+           bucket i, e.g. "<10ms", or NULL if i is out of range.
+        */
+        static char const * AgeBucketLabel( int i )
+        {
+            static char const * const labels[ClassStatsRecord::AgeBuckets] = {
+                "<1ms", "<10ms", "<100ms", "<1s", "<10s", "<100s", ">=100s"
+            };
+            return ((i < 0) || (i >= ClassStatsRecord::AgeBuckets)) ? 0 : labels[i];
+        }
+
+        /**
+           Returns the records as a human-readable table, one class
+           per line.
+        */
+        static std::string ToString()
+        {
+            std::vector<ClassStatsRecord> const li( Stats() );
+            std::ostringstream os;
+            os << std::left << std::setw(24) << "class" << std::right
+               << std::setw(10) << "live"
+               << std::setw(10) << "created"
+               << std::setw(10) << "destroyed"
+               << std::setw(10) << "explicit"
+               << std::setw(10) << "gc"
+               << "  age at destruction:";
+            for( int i = 0; i < ClassStatsRecord::AgeBuckets; ++i )
+            {
+                os << ' ' << AgeBucketLabel(i);
+            }
+            os << '\n';
+            std::vector<ClassStatsRecord>::const_iterator it = li.begin();
+            for( ; li.end() != it; ++it )
+            {
+                ClassStatsRecord const & st( *it );
+                os << std::left << std::setw(24) << st.Name << std::right
+                   << std::setw(10) << st.Live
+                   << std::setw(10) << st.Created
+                   << std::setw(10) << st.Destroyed
+                   << std::setw(10) << st.DestroyedExplicitly
+                   << std::setw(10) << st.DestroyedByGC
+                   << "  ";
+                for( int i = 0; i < ClassStatsRecord::AgeBuckets; ++i )
+                {
+                    os << ' ' << st.AgeAtDestruction[i];
+                }
+                os << '\n';
+            }
+            return os.str();
+        }
+
+        /**
+           Returns the records as a JS object mapping each class name
+           to an object with the properties (live, created, destroyed,
+           destroyedExplicitly, destroyedByGC, ageAtDestruction). The
+           latter is an object mapping AgeBucketLabel() values to
+           counts.
+        */
+        static v8::Handle<v8::Object> ToJS()
+        {
+            std::vector<ClassStatsRecord> const li( Stats() );
+            v8::HandleScope hsc;
+            v8::Handle<v8::Object> rc( v8::Object::New() );
+            std::vector<ClassStatsRecord>::const_iterator it = li.begin();
+            for( ; li.end() != it; ++it )
+            {
+                ClassStatsRecord const & st( *it );
+                v8::Handle<v8::Object> o( v8::Object::New() );
+                o->Set( CVV8_SYMBOL("live"), v8::Number::New( static_cast<double>(st.Live) ) );
+                o->Set( CVV8_SYMBOL("created"), v8::Number::New( static_cast<double>(st.Created) ) );
+                o->Set( CVV8_SYMBOL("destroyed"), v8::Number::New( static_cast<double>(st.Destroyed) ) );
+                o->Set( CVV8_SYMBOL("destroyedExplicitly"), v8::Number::New( static_cast<double>(st.DestroyedExplicitly) ) );
+                o->Set( CVV8_SYMBOL("destroyedByGC"), v8::Number::New( static_cast<double>(st.DestroyedByGC) ) );
+                v8::Handle<v8::Object> ages( v8::Object::New() );
+                for( int i = 0; i < ClassStatsRecord::AgeBuckets; ++i )
+                {
+                    ages->Set( v8::String::New( AgeBucketLabel(i) ),
+                               v8::Number::New( static_cast<double>(st.AgeAtDestruction[i]) ) );
+                }
+                o->Set( CVV8_SYMBOL("ageAtDestruction"), ages );
+                rc->Set( v8::String::New( st.Name ), o );
+            }
+            return hsc.Close( rc );
+        }
+
+        /** v8::InvocationCallback which returns ToJS(). */
+        static v8::Handle<v8::Value> StatsCallback( v8::Arguments const & )
+        {
+            return ToJS();
+        }
+
+        /**
+           v8::InvocationCallback which returns ToString() as a JS
+           string.
+        */
+        static v8::Handle<v8::Value> TextCallback( v8::Arguments const & )
+        {
+            std::string const s( ToString() );
+            return v8::String::New( s.c_str(), static_cast<int>(s.size()) );
+        }
+    };
+
+#if !defined(DOXYGEN)
+namespace Detail {
+#if CVV8_CONFIG_ENABLE_CLASS_STATS
+    /**
+       Collects the ClassStatsRecord for ClassCreator<T>. ClassCreator
+       calls Register() when it is instantiated, Created() after
+       wrapping a new native and Destroyed() when unwrapping one.
+    */
+    template <typename T>
+    class ClassStatsTracker
+    {
+    private:
+        struct State
+        {
+            ClassStatsRecord stats;
+            /** Maps live natives to their creation times (in ms). */
+            PtrHashMap<double> born;
+            State() : stats(), born() {}
+        };
+
+        static State & state()
+        {
+            static State bob;
+            return bob;
+        }
+
+        static double nowMs()
+        {
+            return WallClockUs() / 1000.0;
+        }
+
+    public:
+        static void Register( char const * name )
+        {
+            State & s( state() );
+            StatsLock const lk( ClassStats::Mutex() );
+            if( s.stats.Name ) return;
+            s.stats.Name = name;
+            ClassStats::Records().push_back( &s.stats );
+        }
+
+        static void Created( void const * native )
+        {
+            State & s( state() );
+            double const now = nowMs();
+            StatsLock const lk( ClassStats::Mutex() );
+            ++s.stats.Created;
+            ++s.stats.Live;
+            s.born.Insert( native, now );
+        }
+
+        static void Destroyed( void const * native, bool explicitly )
+        {
+            State & s( state() );
+            double const now = nowMs();
+            StatsLock const lk( ClassStats::Mutex() );
+            double born = 0;
+            if( !s.born.Erase( native, &born ) ) return;
+            --s.stats.Live;
+            ++s.stats.Destroyed;
+            ++(explicitly ? s.stats.DestroyedExplicitly : s.stats.DestroyedByGC);
+            double const age = now - born;
+            int b = 0;
+            for( double lim = 1; (b < ClassStatsRecord::AgeBuckets - 1) && (age >= lim); lim *= 10 ) ++b;
+            ++s.stats.AgeAtDestruction[b];
+        }
+    };
+#else
+    /** No-op when class statistics are disabled. */
+    template <typename T>
+    struct ClassStatsTracker
+    {
+        static void Register( char const * ) {}
+        static void Created( void const * ) {}
+        static void Destroyed( void const *, bool ) {}
+    };
+#endif /* CVV8_CONFIG_ENABLE_CLASS_STATS */
+}
+#endif /* DOXYGEN */
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_CLASS_STATS_HPP_INCLUDED */
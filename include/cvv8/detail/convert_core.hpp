@@ -19,6 +19,9 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <new>
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <sstream>
 
@@ -27,8 +30,83 @@
 #  define CVV8_CONFIG_HAS_LONG_LONG 0
 #endif
 
+#if !defined(CVV8_CONFIG_HAS_UNORDERED_MAP)
+/* std::unordered_map requires C++0x (or MSVC 2010+). */
+#  if defined(__GXX_EXPERIMENTAL_CXX0X__) || (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1600))
+#    define CVV8_CONFIG_HAS_UNORDERED_MAP 1
+#  else
+#    define CVV8_CONFIG_HAS_UNORDERED_MAP 0
+#  endif
+#endif
+
+#if !defined(CVV8_CONFIG_HAS_STRING_MAYCONTAINNONASCII)
+/* v8::String::MayContainNonAscii() and WriteAscii() allow a faster
+   string-to-native conversion for pure-ASCII strings, but they are
+   not available in all v8 versions. */
+#  define CVV8_CONFIG_HAS_STRING_MAYCONTAINNONASCII 0
+#endif
+
+#if !defined(CVV8_CONFIG_HAS_STD_THREAD)
+/* std::thread, std::mutex and std::chrono require C++0x (or MSVC 2012+). */
+#  if defined(__GXX_EXPERIMENTAL_CXX0X__) || (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1700))
+#    define CVV8_CONFIG_HAS_STD_THREAD 1
+#  else
+#    define CVV8_CONFIG_HAS_STD_THREAD 0
+#  endif
+#endif
+
+#if !defined(CVV8_CONFIG_HAS_ISOLATE_LOCKING)
+/* v8::Locker and v8::Unlocker take a v8::Isolate argument in v8 3.6
+   and later. If true, bindings unlock the current isolate instead of
+   the default one, which V8ShellPool requires. */
+#  define CVV8_CONFIG_HAS_ISOLATE_LOCKING 0
+#endif
+
+#if !defined(CVV8_CONFIG_ENABLE_PROFILER)
+/* If true, InCaProfiler records per-binding call statistics,
+   otherwise it compiles to a plain forwarding call. */
+#  define CVV8_CONFIG_ENABLE_PROFILER 0
+#endif
+
+#if !defined(CVV8_CONFIG_ENABLE_CLASS_STATS)
+/* If true, ClassCreator keeps per-class instance statistics (see
+   ClassStats), otherwise the counting code is compiled out. */
+#  define CVV8_CONFIG_ENABLE_CLASS_STATS 0
+#endif
+
+#if !defined(CVV8_CONFIG_ENABLE_LOCK_STATS)
+/* If true, UnlockV8 bindings and TimedLocker record v8 lock contention
+   statistics (see LockStats), otherwise the timing code is compiled
+   out. */
+#  define CVV8_CONFIG_ENABLE_LOCK_STATS 0
+#endif
+
+#if !defined(CVV8_CONFIG_PROTOTYPE_SEARCH_DEPTH)
+/* The maximum number of prototype levels searched when looking for the
+   JS object which holds a bound native (see
+   JSToNative_ObjectWithInternalFields). 0 means no limit. */
+#  define CVV8_CONFIG_PROTOTYPE_SEARCH_DEPTH 32
+#endif
+
+#if !defined(CVV8_THREAD_LOCAL)
+#  if defined(_MSC_VER)
+#    define CVV8_THREAD_LOCAL __declspec(thread)
+#  else
+#    define CVV8_THREAD_LOCAL __thread
+#  endif
+#endif
+
+#if CVV8_CONFIG_HAS_UNORDERED_MAP
+#  include <unordered_map>
+#endif
+
 #include "signature_core.hpp" /* only needed for the Signature used by the generated code. */
 #include "tmp.hpp"
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+#  include <type_traits>
+#  include <utility>
+#endif
+#include "symbol_cache.hpp"
 
 namespace cvv8 {
 
@@ -413,6 +491,58 @@ namespace cvv8 {
     };
 
 
+    /**
+       A non-owning (pointer, length) view of a string.
+
+       Its main purpose is to give bound natives access to JS string
+       arguments without copying them into a std::string: see
+       ArgCaster<StringView>. Views produced by that class are
+       NUL-terminated, so data() may also be passed to C APIs, but
+       StringView objects in general need not be.
+
+       It can also be returned from bound functions, in which case it
+       is converted to a JS string (the bytes are copied).
+    */
+    class StringView
+    {
+    private:
+        char const * ptr;
+        std::size_t len;
+    public:
+        /** Creates an empty view with a null data() pointer. */
+        StringView() : ptr(0), len(0)
+        {}
+        /** Creates a view of the first n bytes of p. */
+        StringView( char const * p, std::size_t n ) : ptr(p), len(n)
+        {}
+        /** Creates a view of the NUL-terminated string p, which may be 0. */
+        StringView( char const * p ) : ptr(p), len(p ? std::strlen(p) : 0)
+        {}
+        /** Returns the start of the string. May be 0. */
+        char const * data() const { return this->ptr; }
+        /** Returns the length of the string, in bytes. */
+        std::size_t size() const { return this->len; }
+        /** Returns true if size() is 0. */
+        bool empty() const { return 0 == this->len; }
+        char const * begin() const { return this->ptr; }
+        char const * end() const { return this->ptr + this->len; }
+        /** Returns a copy of the viewed bytes. */
+        std::string str() const
+        {
+            return this->ptr ? std::string( this->ptr, this->len ) : std::string();
+        }
+        /** Returns true if both views refer to equal byte sequences. */
+        bool operator==( StringView const & rhs ) const
+        {
+            return (this->len == rhs.len)
+                && ((this->ptr == rhs.ptr) || (0 == std::memcmp( this->ptr, rhs.ptr, this->len )));
+        }
+        bool operator!=( StringView const & rhs ) const
+        {
+            return !this->operator==(rhs);
+        }
+    };
+
     template <>
     struct NativeToJS<std::string>
     {
@@ -434,6 +564,17 @@ namespace cvv8 {
         }
     };
 
+    /** Converts a StringView to a JS string, or null if v.data() is 0. */
+    template <>
+    struct NativeToJS<StringView>
+    {
+        v8::Handle<v8::Value> operator()( StringView const & v ) const
+        {
+            if( ! v.data() ) return v8::Null();
+            else return v8::String::New( v.data(), static_cast<int>( v.size() ) );
+        }
+    };
+
     /**
        "Casts" v to a JS value using NativeToJS<T>.
     */
@@ -444,6 +585,23 @@ namespace cvv8 {
         return F()( v );
     }
 
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+    /**
+       Overload for rvalues, which passes v on to NativeToJS<T> as an
+       rvalue, so that implementations which copy v (e.g.
+       NativeToJSMap<T>::NativeToJSImpl) can move it instead. This
+       is what bound functions returning by value end up calling.
+    */
+    template <typename T>
+    inline typename std::enable_if< !std::is_lvalue_reference<T>::value,
+                                    v8::Handle<v8::Value> >::type
+    CastToJS( T && v )
+    {
+        typedef NativeToJS<T const> F;
+        return F()( std::move(v) );
+    }
+#endif
+
     /**
        Overload to avoid ambiguity in certain calls.
     */
@@ -775,6 +933,237 @@ namespace cvv8 {
         }
     };
 
+#if !defined(DOXYGEN)
+    namespace Detail {
+        /**
+           The per-prototype cache used by InternalFieldsLookup::Find().
+           It maps type IDs to the object in the prototype chain which
+           held a native of that type the last time one was looked up.
+
+           One instance is attached to a prototype object via an
+           External in a hidden value, and is deleted when that
+           prototype is garbage-collected. The cached holders are
+           referenced weakly, so that a holder which is unlinked from
+           the chain (e.g. by assigning to __proto__) is not kept
+           alive by the cache.
+        */
+        class PrototypeHolderCache
+        {
+        private:
+            typedef std::map< void const *, v8::Persistent<v8::Object> > MapT;
+            MapT holders;
+            v8::Persistent<v8::Object> owner;
+
+            PrototypeHolderCache() : holders(), owner() {}
+            PrototypeHolderCache( PrototypeHolderCache const & );
+            PrototypeHolderCache & operator=( PrototypeHolderCache const & );
+            ~PrototypeHolderCache()
+            {
+                MapT::iterator it = holders.begin();
+                for( ; holders.end() != it; ++it )
+                {
+                    if( ! it->second.IsEmpty() ) it->second.Dispose();
+                }
+                owner.Dispose();
+            }
+
+            static v8::Handle<v8::String> key()
+            {
+                return CVV8_SYMBOL("cvv8::nativeHolders");
+            }
+
+            /** Weak callback for the owning prototype. */
+            static void ownerGone( v8::Persistent<v8::Value>, void * self )
+            {
+                delete static_cast<PrototypeHolderCache *>(self);
+            }
+
+            /** Weak callback for a cached holder. */
+            static void holderGone( v8::Persistent<v8::Value>, void * entry )
+            {
+                v8::Persistent<v8::Object> & h( *static_cast<v8::Persistent<v8::Object> *>(entry) );
+                h.Dispose();
+                h.Clear();
+            }
+
+            /**
+               Returns proto's cache, or NULL if it has none and create
+               is false.
+            */
+            static PrototypeHolderCache * forPrototype( v8::Handle<v8::Object> const & proto, bool create )
+            {
+                v8::Local<v8::Value> const ev( proto->GetHiddenValue( key() ) );
+                if( !ev.IsEmpty() && ev->IsExternal() )
+                {
+                    return static_cast<PrototypeHolderCache *>( v8::External::Cast(*ev)->Value() );
+                }
+                else if( !create ) return NULL;
+                PrototypeHolderCache * c = new PrototypeHolderCache;
+                c->owner = v8::Persistent<v8::Object>::New( proto );
+                c->owner.MakeWeak( c, ownerGone );
+                proto->SetHiddenValue( key(), v8::External::New( c ) );
+                return c;
+            }
+
+        public:
+            /**
+               Returns the holder cached in proto for the given type
+               ID, or an empty handle if there is none or it has been
+               collected.
+            */
+            static v8::Local<v8::Object> Get( v8::Handle<v8::Object> const & proto, void const * typeID )
+            {
+                PrototypeHolderCache const * c = forPrototype( proto, false );
+                if( !c ) return v8::Local<v8::Object>();
+                MapT::const_iterator it = c->holders.find( typeID );
+                return ((c->holders.end() == it) || it->second.IsEmpty())
+                    ? v8::Local<v8::Object>()
+                    : v8::Local<v8::Object>::New( it->second );
+            }
+
+            /** Caches holder in proto for the given type ID. */
+            static void Set( v8::Handle<v8::Object> const & proto, void const * typeID,
+                             v8::Handle<v8::Object> const & holder )
+            {
+                PrototypeHolderCache * c = forPrototype( proto, true );
+                v8::Persistent<v8::Object> & h( c->holders[typeID] );
+                if( ! h.IsEmpty() ) h.Dispose();
+                h = v8::Persistent<v8::Object>::New( holder );
+                h.MakeWeak( &h, holderGone );
+            }
+        };
+
+        /**
+           Shared implementation of the native lookups done by
+           JSToNative_ObjectWithInternalFields,
+           JSToNative_ObjectWithInternalFieldsTypeSafe and ClassCreator.
+
+           An object "holds a native" if it has exactly FieldCount
+           internal fields, its TypeIdIndex field holds the expected
+           type ID (this check is skipped if TypeIdIndex is negative),
+           and its ObjectIndex field is not NULL.
+
+           If the type ID does not match and an upcast function is
+           given, the object's own type ID and native are passed to
+           it, and its result is used. ClassCreator uses this (via
+           ClassHierarchy::Upcast()) to accept instances of registered
+           subclasses.
+        */
+        template <int FieldCount, int TypeIdIndex, int ObjectIndex>
+        struct InternalFieldsLookup
+        {
+            /**
+               Converts a native whose type ID is typeID to the type
+               being looked up, or returns NULL if it cannot.
+            */
+            typedef void * (*NativeUpcast)( void const * typeID, void * native );
+
+            /** Returns obj's native if it holds one, else NULL. */
+            static void * Native( v8::Local<v8::Object> const & obj,
+                                  void const * typeID,
+                                  NativeUpcast upcast = NULL )
+            {
+                if( obj->InternalFieldCount() != FieldCount ) return NULL;
+                else if( TypeIdIndex >= 0 )
+                {
+                    void const * const tid = obj->GetPointerFromInternalField( TypeIdIndex );
+                    if( tid == typeID ) return obj->GetPointerFromInternalField( ObjectIndex );
+                    else if( !upcast ) return NULL;
+                    else return upcast( tid, obj->GetPointerFromInternalField( ObjectIndex ) );
+                }
+                else return obj->GetPointerFromInternalField( ObjectIndex );
+            }
+
+            /**
+               Returns the native held by h or, if searchPrototypes is
+               true and h does not hold one, by the nearest object in
+               h's prototype chain which does, searching at most
+               CVV8_CONFIG_PROTOTYPE_SEARCH_DEPTH levels (0 meaning no
+               limit). Returns NULL if none is found. If holder is not
+               NULL then it is set to the object the native was found
+               in.
+
+               An object which holds its own native (the common case)
+               costs one field count check and one type ID comparison.
+               JS-side subclass instances are handled by walking the
+               prototype chain, and the holder is then remembered, per
+               type ID, in h's prototype (which all instances of the
+               same JS subclass share; see PrototypeHolderCache).
+               Later lookups only check the internal field count of
+               the objects in the chain until they reach the cached
+               holder, rather than reading their fields. If the cached
+               holder is no longer in the chain (e.g. after __proto__
+               was changed), or an object before it has FieldCount
+               internal fields (and so might hold a nearer native), or
+               the holder no longer holds a matching native, the chain
+               is searched again and the cache entry replaced.
+
+               upcast is passed on to Native().
+            */
+            static void * Find( v8::Handle<v8::Value> const & h,
+                                void const * typeID,
+                                bool searchPrototypes,
+                                v8::Handle<v8::Object> * holder = NULL,
+                                NativeUpcast upcast = NULL )
+            {
+                if( h.IsEmpty() || ! h->IsObject() ) return NULL;
+                v8::Local<v8::Object> obj( v8::Object::Cast( *h ) );
+                void * ext = Native( obj, typeID, upcast );
+                if( !ext && searchPrototypes )
+                {
+                    v8::Local<v8::Value> pv( obj->GetPrototype() );
+                    if( pv.IsEmpty() || ! pv->IsObject() ) return NULL;
+                    v8::Local<v8::Object> const proto( v8::Object::Cast( *pv ) );
+                    obj = proto;
+                    ext = Native( obj, typeID, upcast );
+                    if( !ext )
+                    {
+                        v8::Local<v8::Object> const cached( PrototypeHolderCache::Get( proto, typeID ) );
+                        if( ! cached.IsEmpty() )
+                        {
+                            pv = proto->GetPrototype();
+                            for( int depth = 2;
+                                 (!CVV8_CONFIG_PROTOTYPE_SEARCH_DEPTH || (depth <= CVV8_CONFIG_PROTOTYPE_SEARCH_DEPTH))
+                                 && !pv.IsEmpty() && pv->IsObject();
+                                 ++depth )
+                            {
+                                obj = v8::Local<v8::Object>( v8::Object::Cast( *pv ) );
+                                if( obj == cached )
+                                {
+                                    ext = Native( obj, typeID, upcast );
+                                    break;
+                                }
+                                else if( obj->InternalFieldCount() == FieldCount )
+                                {
+                                    break /* may hold a nearer native: search again */;
+                                }
+                                pv = obj->GetPrototype();
+                            }
+                        }
+                        if( !ext )
+                        {
+                            pv = proto->GetPrototype();
+                            for( int depth = 2;
+                                 !ext
+                                 && (!CVV8_CONFIG_PROTOTYPE_SEARCH_DEPTH || (depth <= CVV8_CONFIG_PROTOTYPE_SEARCH_DEPTH))
+                                 && !pv.IsEmpty() && pv->IsObject();
+                                 ++depth )
+                            {
+                                obj = v8::Local<v8::Object>( v8::Object::Cast( *pv ) );
+                                ext = Native( obj, typeID, upcast );
+                                if( !ext ) pv = obj->GetPrototype();
+                            }
+                            if( ext ) PrototypeHolderCache::Set( proto, typeID, obj );
+                        }
+                    }
+                }
+                if( ext && holder ) *holder = obj;
+                return ext;
+            }
+        };
+    }
+#endif
+
     /**
        A concrete JSToNative implementation intended to be used as the
        base class for JSToNative<T> implementations where T is "bound
@@ -839,31 +1228,16 @@ namespace cvv8 {
            of the passed-in handle.
 
            If SearchPrototypeChain is true and this object does not
-           contain a native then the prototype chain is searched.
+           contain a native then the prototype chain is searched
+           (see Detail::InternalFieldsLookup::Find() for the details).
            This is generally only required when bound types are
            subclassed.
         */
         ResultType operator()( v8::Handle<v8::Value> const & h ) const
         {
-            if( h.IsEmpty() || ! h->IsObject() ) return NULL;
-            else
-            {
-                void * ext = NULL;
-                v8::Handle<v8::Value> proto(h);
-                while( !ext && !proto.IsEmpty() && proto->IsObject() )
-                {
-                    v8::Local<v8::Object> const & obj( v8::Object::Cast( *proto ) );
-                    ext = (obj->InternalFieldCount() != InternalFieldCount)
-                        ? NULL
-                        : obj->GetPointerFromInternalField( InternalFieldIndex );
-                    if( ! ext )
-                    {
-                        if( !SearchPrototypeChain ) break;
-                        else proto = obj->GetPrototype();
-                    }
-                }
-                return ext ? static_cast<ResultType>(ext) : NULL;
-            }
+            typedef Detail::InternalFieldsLookup<InternalFieldCount, -1, InternalFieldIndex> Lookup;
+            void * const ext = Lookup::Find( h, NULL, SearchPrototypeChain );
+            return ext ? static_cast<ResultType>(ext) : NULL;
         }
     };
 
@@ -972,34 +1346,15 @@ namespace cvv8 {
 
            If SearchPrototypeChain is true and the object does not 
            contain a native then the prototype chain is searched 
-           recursively. This is generally only required when bound 
-           types are subclassed from JS code.           
+           (see Detail::InternalFieldsLookup::Find() for the details).
+           This is generally only required when bound types are
+           subclassed from JS code.
         */
         ResultType operator()( v8::Handle<v8::Value> const & h ) const
         {
-            if( h.IsEmpty() || ! h->IsObject() ) return NULL;
-            else
-            {
-                void const * tid = NULL;
-                void * ext = NULL;
-                v8::Handle<v8::Value> proto(h);
-                while( !ext && !proto.IsEmpty() )// && proto->IsObject() )
-                {
-                    v8::Local<v8::Object> const & obj( v8::Object::Cast( *proto ) );
-                    tid = (obj->InternalFieldCount() != InternalFieldCount)
-                        ? NULL
-                        : obj->GetPointerFromInternalField( TypeIdFieldIndex );
-                    ext = (tid == TypeID)
-                        ? obj->GetPointerFromInternalField( ObjectFieldIndex )
-                        : NULL;
-                    if( ! ext )
-                    {
-                        if( ! SearchPrototypeChain ) break;
-                        else proto = obj->GetPrototype();
-                    }
-                }
-                return ext ? static_cast<ResultType>(ext) : NULL;
-            }
+            typedef Detail::InternalFieldsLookup<InternalFieldCount, TypeIdFieldIndex, ObjectFieldIndex> Lookup;
+            void * const ext = Lookup::Find( h, TypeID, SearchPrototypeChain );
+            return ext ? static_cast<ResultType>(ext) : NULL;
         }
     };
 
@@ -1119,19 +1474,230 @@ namespace cvv8 {
         }
     };
 
-    /** Specialization to convert JS values to std::string. */
+#if !defined(DOXYGEN)
+    namespace Detail
+    {
+        /**
+           Returns h as a JS string, converting it via toString() if
+           needed. Returns an empty handle if h is empty or if
+           toString() throws.
+        */
+        inline v8::Handle<v8::String> ToJSString( v8::Handle<v8::Value> const & h )
+        {
+            if( h.IsEmpty() ) return v8::Handle<v8::String>();
+            else if( h->IsString() ) return v8::Handle<v8::String>::Cast( h );
+            else return h->ToString();
+        }
+
+        /**
+           Returns an upper bound for the number of bytes needed to
+           store the UTF-8 form of s (without a NUL terminator). If
+           exact is true then the exact length is calculated, which
+           costs an extra pass over the string, otherwise a cheap
+           estimate (3 bytes per UTF-16 unit) is used.
+        */
+        inline std::size_t Utf8Capacity( v8::Handle<v8::String> const & s, bool exact )
+        {
+#if CVV8_CONFIG_HAS_STRING_MAYCONTAINNONASCII
+            if( ! s->MayContainNonAscii() ) return static_cast<std::size_t>( s->Length() );
+#endif
+            return exact
+                ? static_cast<std::size_t>( s->Utf8Length() )
+                : static_cast<std::size_t>( s->Length() ) * 3;
+        }
+
+        /**
+           Writes the UTF-8 form of s to dest, which must have room for
+           at least cap+1 bytes, where cap comes from
+           Utf8Capacity(s,...). Always NUL-terminates dest. Returns the
+           number of bytes written, not counting the terminator.
+        */
+        inline std::size_t WriteUtf8( v8::Handle<v8::String> const & s, char * dest, std::size_t cap )
+        {
+            int const max = static_cast<int>( cap + 1 );
+#if CVV8_CONFIG_HAS_STRING_MAYCONTAINNONASCII
+            if( ! s->MayContainNonAscii() )
+            {
+                int const n = s->WriteAscii( dest, 0, max );
+                dest[n] = 0;
+                return static_cast<std::size_t>( n );
+            }
+#endif
+            /* With room for the terminator, WriteUtf8() writes it and
+               includes it in the returned count, but it returns 0 (and
+               may write nothing) in some error cases, so terminate
+               dest here as well. */
+            int const n = s->WriteUtf8( dest, max );
+            std::size_t const len = (n > 0) ? static_cast<std::size_t>( n - 1 ) : 0;
+            dest[len] = 0;
+            return len;
+        }
+
+        /**
+           A per-thread, stack-like scratch arena used by
+           StringArgBuffer for strings which do not fit in its inline
+           storage. Regions must be released in the reverse order of
+           their acquisition, which is naturally the case for the
+           ArgCaster objects which use it.
+
+           The memory is reused across calls and is only reallocated
+           (grown) when it is not in use. It is never freed, except
+           that requests larger than MaxKeep bytes are not served from
+           here at all, so that one huge string does not pin a huge
+           buffer for the rest of the thread's life.
+        */
+        class StringArgArena
+        {
+        private:
+            struct State
+            {
+                char * mem;
+                std::size_t cap;
+                std::size_t top;
+                unsigned int live;
+            };
+            static State & state()
+            {
+                static CVV8_THREAD_LOCAL State bob = { 0, 0, 0, 0 };
+                return bob;
+            }
+        public:
+            enum { MaxKeep = 1024 * 256 };
+            /**
+               Tries to reserve n bytes. On success it returns the
+               memory and sets mark to a value which must be passed to
+               Release(). Returns 0 if the request cannot be served
+               from the arena, in which case the caller must allocate
+               the memory some other way.
+            */
+            static char * Acquire( std::size_t n, std::size_t & mark )
+            {
+                State & st( state() );
+                if( n > MaxKeep ) return 0;
+                else if( (st.cap - st.top) < n )
+                {
+                    if( st.live ) return 0;
+                    std::size_t cap = st.cap ? st.cap : 1024;
+                    while( cap < n ) cap <<= 1;
+                    delete [] st.mem;
+                    st.mem = 0;
+                    st.cap = 0;
+                    st.mem = new char[cap];
+                    st.cap = cap;
+                }
+                mark = st.top;
+                st.top += n;
+                ++st.live;
+                return st.mem + mark;
+            }
+            /**
+               Releases a region acquired via Acquire(n, mark).
+            */
+            static void Release( std::size_t n, std::size_t mark )
+            {
+                State & st( state() );
+                if( (mark + n) == st.top ) st.top = mark;
+                if( 0 == --st.live ) st.top = 0;
+            }
+        };
+
+        /**
+           Scratch memory for a converted string argument. Strings
+           of up to InlineSize-1 bytes are stored in the object
+           itself (which lives on the stack in the generated
+           forwarders), larger ones in the thread's StringArgArena,
+           and only if that is not possible, on the heap.
+        */
+        template <std::size_t InlineSize>
+        class StringArgBuffer
+        {
+        private:
+            enum Source { FromInline, FromArena, FromHeap };
+            char inl[InlineSize];
+            char * mem;
+            std::size_t len;
+            std::size_t mark;
+            Source src;
+            StringArgBuffer( StringArgBuffer const & );
+            StringArgBuffer & operator=( StringArgBuffer const & );
+        public:
+            StringArgBuffer() : mem(inl), len(0), mark(0), src(FromInline)
+            {}
+            ~StringArgBuffer()
+            {
+                this->Clear();
+            }
+            /** Frees any memory allocated by Reserve(). */
+            void Clear()
+            {
+                if( FromArena == this->src ) StringArgArena::Release( this->len, this->mark );
+                else if( FromHeap == this->src ) delete [] this->mem;
+                this->mem = this->inl;
+                this->len = 0;
+                this->src = FromInline;
+            }
+            /**
+               Returns a buffer of at least n bytes, invalidating any
+               buffer returned by a previous call.
+            */
+            char * Reserve( std::size_t n )
+            {
+                this->Clear();
+                if( n <= InlineSize ) return this->mem;
+                char * m = StringArgArena::Acquire( n, this->mark );
+                if( m ) this->src = FromArena;
+                else
+                {
+                    m = new char[n];
+                    this->src = FromHeap;
+                }
+                this->mem = m;
+                this->len = n;
+                return m;
+            }
+            /**
+               Converts h to a UTF-8 string stored in this object and
+               returns a view of it. The view is NUL-terminated. If
+               h is empty or its toString() throws, an empty view with
+               a null data() pointer is returned.
+            */
+            StringView Assign( v8::Handle<v8::Value> const & h )
+            {
+                v8::Handle<v8::String> const s( ToJSString( h ) );
+                if( s.IsEmpty() )
+                {
+                    this->Clear();
+                    return StringView();
+                }
+                /* For short strings the 3-bytes-per-unit estimate
+                   fits in the inline buffer, saving a pass over the
+                   string. */
+                std::size_t cap = Utf8Capacity( s, false );
+                if( cap >= InlineSize ) cap = Utf8Capacity( s, true );
+                char * dest = this->Reserve( cap + 1 );
+                return StringView( dest, WriteUtf8( s, dest, cap ) );
+            }
+        };
+    }
+#endif // DOXYGEN
+
+    /**
+       Specialization to convert JS values to std::string. The
+       string's bytes are written directly into the result, without
+       intermediary copies.
+    */
     template <>
     struct JSToNative<std::string>
     {
         typedef std::string ResultType;
         ResultType operator()( v8::Handle<v8::Value> const & h ) const
         {
-            static const std::string emptyString;
-            v8::String::Utf8Value const utf8String( h );
-            const char* s = *utf8String;
-            return s
-                ? std::string(s, utf8String.length())
-                : emptyString;
+            v8::Handle<v8::String> const s( Detail::ToJSString( h ) );
+            if( s.IsEmpty() ) return std::string();
+            std::size_t const cap = Detail::Utf8Capacity( s, true );
+            std::string rv( cap + 1, '\0' );
+            rv.resize( Detail::WriteUtf8( s, &rv[0], cap ) );
+            return rv;
         }
     };
     
@@ -1380,11 +1946,12 @@ namespace cvv8 {
             return *this;
         }
         /**
-           Adds an arbtirary property to the target object.
+           Adds an arbtirary property to the target object. The key
+           string is fetched from the SymbolCache.
         */
         inline ObjectPropSetter & Set( char const * key, v8::Handle<v8::Value> const & v )
         {
-            this->target->Set( v8::String::New(key), CastToJS(v));
+            this->target->Set( SymbolCache::Get(key), CastToJS(v));
             return *this;
         }
 
@@ -1409,14 +1976,14 @@ namespace cvv8 {
         }
 
         /**
-           Adds a string-keyed property to the target object.
-           Note that if key is NULL, the v8::String constructor
-           will crash your app. (Good luck with that!)
+           Adds a string-keyed property to the target object. The key
+           string is fetched from the SymbolCache. Note that if key is
+           NULL, your app will crash. (Good luck with that!)
         */
         template <typename T>
         inline ObjectPropSetter & operator()( char const * key, T const & v )
         {
-            return this->Set( v8::String::New(key), CastToJS(v) );
+            return this->Set( key, CastToJS(v) );
         }
 
 
@@ -1451,9 +2018,9 @@ namespace cvv8 {
 	    const size_t sz = li.size();
 #if 1
 	    v8::Handle<v8::Array> rv( v8::Array::New( static_cast<int>(sz) ) );
-	    for( int i = 0; li.end() != it; ++it, ++i )
+	    for( uint32_t i = 0; li.end() != it; ++it, ++i )
 	    {
-		rv->Set( v8::Integer::New(i), CastToJS( *it ) );
+		rv->Set( i, CastToJS( *it ) );
 	    }
 	    return rv;
 #else
@@ -1501,6 +2068,31 @@ namespace cvv8 {
     template <typename KeyT,typename ValT>
     struct NativeToJS< std::map<KeyT,ValT> > : NativeToJS_map< std::map<KeyT,ValT> > {};
 
+    /** Partial specialization for flat maps (vectors of (key,value) pairs). */
+    template <typename KeyT,typename ValT>
+    struct NativeToJS< std::vector< std::pair<KeyT,ValT> > > : NativeToJS_map< std::vector< std::pair<KeyT,ValT> > > {};
+
+#if CVV8_CONFIG_HAS_UNORDERED_MAP
+    /** Partial specialization for std::unordered_map<>. */
+    template <typename KeyT,typename ValT>
+    struct NativeToJS< std::unordered_map<KeyT,ValT> > : NativeToJS_map< std::unordered_map<KeyT,ValT> > {};
+#endif
+
+#if !defined(DOXYGEN)
+    namespace Detail
+    {
+        /** Pre-sizes li to hold n elements, if ListT supports that. */
+        template <typename ListT>
+        inline void ReserveList( ListT &, std::size_t )
+        {}
+        template <typename T, typename A>
+        inline void ReserveList( std::vector<T,A> & li, std::size_t n )
+        {
+            li.reserve( n );
+        }
+    }
+#endif // DOXYGEN
+
     /**
        A base class for JSToNative<SomeStdListType>
        specializations. ListT must be compatible with std::list and
@@ -1526,7 +2118,9 @@ namespace cvv8 {
            Converts jv to a ListT object.
 
            If jv->IsArray() then the returned object is populated from
-           jv, otherwise the returned object is empty. Since it is
+           jv, up to (not including) the first missing index, so
+           sparse arrays are truncated at their first hole. Otherwise
+           the returned object is empty. Since it is
            legal for an array to be empty, it is not generically
            possible to know if this routine got an empty Array object
            or a non-Array object.
@@ -1538,10 +2132,11 @@ namespace cvv8 {
             ListT li;
             if( jv.IsEmpty() || ! jv->IsArray() ) return li;
             v8::Handle<v8::Array> ar( v8::Array::Cast(*jv) );
-            uint32_t ndx = 0;
-            for( ; ar->Has(ndx); ++ndx )
+            uint32_t const len = ar->Length();
+            Detail::ReserveList( li, len );
+            for( uint32_t ndx = 0; (ndx < len) && ar->Has(ndx); ++ndx )
             {
-                li.push_back( CastFromJS<VALT>( ar->Get(v8::Integer::New(ndx)) ) );
+                li.push_back( CastFromJS<VALT>( ar->Get(ndx) ) );
             }
             return li;
         }
@@ -1555,45 +2150,338 @@ namespace cvv8 {
     template <typename T>
     struct JSToNative< std::vector<T> > : JSToNative_list< std::vector<T> > {};
 
-#if 0 // untested code
+#if !defined(DOXYGEN)
+    namespace Detail
+    {
+        /**
+           Maps the numeric type T to the v8::ExternalArrayType with
+           the same element layout. The Value member is 0 for types
+           which have no such counterpart.
+        */
+        template <typename T>
+        struct ExternalArrayTypeOf : tmp::IntVal<0> {};
+        template <> struct ExternalArrayTypeOf<int8_t> : tmp::IntVal<v8::kExternalByteArray> {};
+        template <> struct ExternalArrayTypeOf<uint8_t> : tmp::IntVal<v8::kExternalUnsignedByteArray> {};
+        template <> struct ExternalArrayTypeOf<int16_t> : tmp::IntVal<v8::kExternalShortArray> {};
+        template <> struct ExternalArrayTypeOf<uint16_t> : tmp::IntVal<v8::kExternalUnsignedShortArray> {};
+        template <> struct ExternalArrayTypeOf<int32_t> : tmp::IntVal<v8::kExternalIntArray> {};
+        template <> struct ExternalArrayTypeOf<uint32_t> : tmp::IntVal<v8::kExternalUnsignedIntArray> {};
+        template <> struct ExternalArrayTypeOf<float> : tmp::IntVal<v8::kExternalFloatArray> {};
+        template <> struct ExternalArrayTypeOf<double> : tmp::IntVal<v8::kExternalDoubleArray> {};
+
+        /**
+           Converts v to T using JS number conversion rules (ToInt32()/
+           ToUint32() for integers, ToNumber() otherwise), truncating to
+           the size of T. Non-numbers convert to 0.
+        */
+        template <typename T>
+        inline T NumberTo( v8::Handle<v8::Value> const & v )
+        {
+            if( v->IsInt32() ) return static_cast<T>( v->Int32Value() );
+            else if( !v->IsNumber() ) return T(0);
+            else if( !std::numeric_limits<T>::is_integer ) return static_cast<T>( v->NumberValue() );
+            else if( std::numeric_limits<T>::is_signed ) return static_cast<T>( v->Int32Value() );
+            else return static_cast<T>( v->Uint32Value() );
+        }
+
+        /**
+           Copies n elements of type SrcT from src to dest, converting
+           them to DestT.
+        */
+        template <typename DestT, typename SrcT>
+        inline void CopyConvert( DestT * dest, void const * src, std::size_t n )
+        {
+            SrcT const * s = static_cast<SrcT const *>(src);
+            for( std::size_t i = 0; i < n; ++i ) dest[i] = static_cast<DestT>(s[i]);
+        }
+
+        /**
+           Copies the contents of obj's external array data (see
+           v8::Object::SetIndexedPropertiesToExternalArrayData())
+           into li, converting the elements to T if needed. When the
+           element types match this is a single memcpy().
+        */
+        template <typename T>
+        void CopyExternalArray( v8::Handle<v8::Object> const & obj, std::vector<T> & li )
+        {
+            std::size_t const n = static_cast<std::size_t>( obj->GetIndexedPropertiesExternalArrayDataLength() );
+            void const * src = obj->GetIndexedPropertiesExternalArrayData();
+            v8::ExternalArrayType const et = obj->GetIndexedPropertiesExternalArrayDataType();
+            li.resize( n );
+            if( !n ) return;
+            else if( static_cast<int>(et) == ExternalArrayTypeOf<T>::Value )
+            {
+                std::memcpy( &li[0], src, n * sizeof(T) );
+                return;
+            }
+            T * dest = &li[0];
+            switch( et )
+            {
+              case v8::kExternalByteArray: CopyConvert<T,int8_t>( dest, src, n ); break;
+              case v8::kExternalPixelArray:
+              case v8::kExternalUnsignedByteArray: CopyConvert<T,uint8_t>( dest, src, n ); break;
+              case v8::kExternalShortArray: CopyConvert<T,int16_t>( dest, src, n ); break;
+              case v8::kExternalUnsignedShortArray: CopyConvert<T,uint16_t>( dest, src, n ); break;
+              case v8::kExternalIntArray: CopyConvert<T,int32_t>( dest, src, n ); break;
+              case v8::kExternalUnsignedIntArray: CopyConvert<T,uint32_t>( dest, src, n ); break;
+              case v8::kExternalFloatArray: CopyConvert<T,float>( dest, src, n ); break;
+              case v8::kExternalDoubleArray: CopyConvert<T,double>( dest, src, n ); break;
+              default: li.clear(); break;
+            }
+        }
+
+        /**
+           Weak-pointer callback for objects created by
+           NewExternalArray(). Frees the external array memory.
+        */
+        template <typename T>
+        void ExternalArrayWeakCallback( v8::Persistent< v8::Value > pv, void * mem )
+        {
+            v8::Local<v8::Object> const obj( v8::Object::Cast(*pv) );
+            int const n = obj->GetIndexedPropertiesExternalArrayDataLength();
+            delete [] static_cast<T*>(mem);
+            v8::V8::AdjustAmountOfExternalAllocatedMemory( -static_cast<int>(n * sizeof(T)) );
+            pv.Dispose();
+            pv.Clear();
+        }
+    }
+#endif // DOXYGEN
+
+    /**
+       Creates a new JS object whose indexed properties are backed by
+       a native copy of the n elements starting at src, laid out
+       exactly as in native memory (see
+       v8::Object::SetIndexedPropertiesToExternalArrayData()). The
+       object also gets a read-only "length" property.
+
+       T must be one of (u)int8_t, (u)int16_t, (u)int32_t, float or
+       double. The copy is a single memcpy() and JS-side element
+       access needs no boxing, which makes this much cheaper than
+       CastToJS(std::vector<T>) for large data sets. Note, however,
+       that the result is not an Array: it has no Array methods and
+       elements cannot be added to it.
+
+       The memory is freed when the object is garbage-collected, and
+       it is reported to v8 via AdjustAmountOfExternalAllocatedMemory()
+       so that the GC knows about it.
+
+       Passing such an object to JSToNative< std::vector<T> > (for
+       any of the types listed above) converts it back with a single
+       memcpy() if the element types match.
+    */
+    template <typename T>
+    v8::Handle<v8::Object> NewExternalArray( T const * src, std::size_t n )
+    {
+        static_assert( Detail::ExternalArrayTypeOf<T>::Value != 0,
+                       "NewExternalArray() requires one of the fixed-size numeric element types." );
+        v8::Handle<v8::Object> obj( v8::Object::New() );
+        T * mem = new T[n ? n : 1];
+        if( n ) std::memcpy( mem, src, n * sizeof(T) );
+        obj->SetIndexedPropertiesToExternalArrayData( mem,
+                static_cast<v8::ExternalArrayType>( Detail::ExternalArrayTypeOf<T>::Value ),
+                static_cast<int>(n) );
+        obj->Set( CVV8_SYMBOL("length"), v8::Integer::New( static_cast<int32_t>(n) ),
+                  v8::PropertyAttribute(v8::ReadOnly | v8::DontEnum | v8::DontDelete) );
+        v8::V8::AdjustAmountOfExternalAllocatedMemory( static_cast<int>(n * sizeof(T)) );
+        v8::Persistent<v8::Object>::New( obj ).MakeWeak( mem, Detail::ExternalArrayWeakCallback<T> );
+        return obj;
+    }
+
+    /** Convenience overload taking a std::vector. */
+    template <typename T>
+    v8::Handle<v8::Object> NewExternalArray( std::vector<T> const & li )
+    {
+        return NewExternalArray<T>( li.empty() ? 0 : &li[0], li.size() );
+    }
+
     /**
-       UNTESTED!
+       A JSToNative base for std::vector<T>, where T is one of the
+       numeric types supported by NewExternalArray(). It is used by
+       the JSToNative specializations for those vector types.
+
+       If the JS value is an object backed by external array data
+       (e.g. from NewExternalArray(), or a typed array/Buffer in
+       embedders which implement them that way), the data are copied
+       in bulk. Plain Arrays are converted element by element, but
+       into a pre-sized vector using uint32_t-indexed access, and,
+       like JSToNative_list, stop at the first hole of sparse arrays.
+       Any other values produce an empty vector.
+    */
+    template <typename T>
+    struct JSToNative_NumericVector
+    {
+        typedef std::vector<T> ResultType;
+        ResultType operator()( v8::Handle<v8::Value> const & jv ) const
+        {
+            ResultType li;
+            if( jv.IsEmpty() || !jv->IsObject() ) return li;
+            else if( jv->IsArray() )
+            {
+                v8::Handle<v8::Array> ar( v8::Array::Cast(*jv) );
+                uint32_t const len = ar->Length();
+                li.resize( len );
+                for( uint32_t i = 0; i < len; ++i )
+                {
+                    if( !ar->Has(i) )
+                    { // stop at the first hole, like JSToNative_list
+                        li.resize( i );
+                        break;
+                    }
+                    li[i] = Detail::NumberTo<T>( ar->Get(i) );
+                }
+                return li;
+            }
+            v8::Handle<v8::Object> const obj( v8::Object::Cast(*jv) );
+            if( obj->HasIndexedPropertiesInExternalArrayData() )
+            {
+                Detail::CopyExternalArray<T>( obj, li );
+            }
+            return li;
+        }
+    };
 
-       Intended as a base class for JSToNative specializations
-       which proxy a std::map-like map.
+    template <> struct JSToNative< std::vector<int8_t> > : JSToNative_NumericVector<int8_t> {};
+    template <> struct JSToNative< std::vector<uint8_t> > : JSToNative_NumericVector<uint8_t> {};
+    template <> struct JSToNative< std::vector<int16_t> > : JSToNative_NumericVector<int16_t> {};
+    template <> struct JSToNative< std::vector<uint16_t> > : JSToNative_NumericVector<uint16_t> {};
+    template <> struct JSToNative< std::vector<int32_t> > : JSToNative_NumericVector<int32_t> {};
+    template <> struct JSToNative< std::vector<uint32_t> > : JSToNative_NumericVector<uint32_t> {};
+    template <> struct JSToNative< std::vector<float> > : JSToNative_NumericVector<float> {};
+    template <> struct JSToNative< std::vector<double> > : JSToNative_NumericVector<double> {};
+
+#if !defined(DOXYGEN)
+    namespace Detail
+    {
+        /** Pre-sizes map to hold n entries, if MapT supports that. */
+        template <typename MapT>
+        inline void ReserveMap( MapT &, std::size_t )
+        {}
+#if CVV8_CONFIG_HAS_UNORDERED_MAP
+        template <typename K, typename V, typename H, typename E, typename A>
+        inline void ReserveMap( std::unordered_map<K,V,H,E,A> & map, std::size_t n )
+        {
+            map.reserve( n );
+        }
+#endif
+        template <typename K, typename V, typename A>
+        inline void ReserveMap( std::vector<std::pair<K,V>,A> & map, std::size_t n )
+        {
+            map.reserve( n );
+        }
+
+        /** Adds (k,v) to map, replacing any existing entry for k. */
+        template <typename MapT, typename K, typename V>
+        inline void MapInsert( MapT & map, K const & k, V const & v )
+        {
+            map[k] = v;
+        }
+        /** Appends (k,v). Sorting happens in FinishMap(). */
+        template <typename K, typename V, typename A, typename K2, typename V2>
+        inline void MapInsert( std::vector<std::pair<K,V>,A> & map, K2 const & k, V2 const & v )
+        {
+            map.push_back( std::pair<K,V>( k, v ) );
+        }
+
+        /** Hook called after a map has been populated. Does nothing. */
+        template <typename MapT>
+        inline void FinishMap( MapT & )
+        {}
+
+        /** Compares pairs by their first member only. */
+        struct PairKeyLess
+        {
+            template <typename P>
+            bool operator()( P const & lhs, P const & rhs ) const
+            {
+                return lhs.first < rhs.first;
+            }
+        };
+        /**
+           Sorts a flat map by key and removes entries with duplicate
+           keys (which can happen when distinct property names convert
+           to the same native key, e.g. "1" and "01" to an integer).
+           The last entry in property order is kept, as (map[k] = v)
+           does for std::map and std::unordered_map.
+        */
+        template <typename K, typename V, typename A>
+        inline void FinishMap( std::vector<std::pair<K,V>,A> & map )
+        {
+            typedef typename std::vector<std::pair<K,V>,A>::iterator IterT;
+            PairKeyLess const less = PairKeyLess();
+            std::stable_sort( map.begin(), map.end(), less );
+            IterT out = map.begin();
+            for( IterT it = map.begin(); map.end() != it; ++out )
+            {
+                IterT last = it;
+                for( ++it; (map.end() != it) && !less( *last, *it ); ++it ) last = it;
+                if( out != last ) *out = *last;
+            }
+            map.erase( out, map.end() );
+        }
+    }
+#endif // DOXYGEN
+
+    /**
+       A base class for JSToNative specializations which convert JS
+       objects to std::map-like types.
+
+       Only the object's own properties are converted: its property
+       names are enumerated once with GetOwnPropertyNames(), so no
+       prototype chain walking is done. Each name is converted using
+       CastFromJS<KeyType>() and each value using
+       CastFromJS<ValueType>().
+
+       MapT must either support (map[key] = value), like std::map and
+       std::unordered_map do, or be a std::vector of std::pairs. In
+       the latter case the resulting vector is sorted by key, so that
+       it can be searched with std::lower_bound() and friends. Where
+       the container supports it, room for all entries is reserved
+       up front.
+
+       If the JS value is not an object, an empty map is returned.
     */
     template <typename MapT,
-              typename KeyType = typename MapT::mapped_type,
-              typename ValueType = typename MapT::value_type>
+              typename KeyType = typename MapT::key_type,
+              typename ValueType = typename MapT::mapped_type>
     struct JSToNative_map
     {
         typedef MapT ResultType;
-        /**
-           Converts jv to a MapT object.
-
-           If jv->IsObject() then the returned object is populated from
-           jv, otherwise the returned object is empty. Since it is
-           legal for an object to be empty, it is not generically
-           possible to know if this routine got an empty Object
-           or a non-Object handle.
-        */
-        ResultType operator()( v8::Handle<v8::Value> jv ) const
+        ResultType operator()( v8::Handle<v8::Value> const & jv ) const
         {
-            typedef ValueType VALT;
             MapT map;
             if( jv.IsEmpty() || ! jv->IsObject() ) return map;
-            Local<Object> obj( Object::Cast(*jv) );
-            Local<Array> ar( obj->GetPropertyNames() );
-            uint32_t ndx = 0;
-            for( ; ar->Has(ndx); ++ndx )
+            v8::Handle<v8::Object> const obj( v8::Object::Cast(*jv) );
+            v8::Handle<v8::Array> const keys( obj->GetOwnPropertyNames() );
+            uint32_t const n = keys->Length();
+            Detail::ReserveMap( map, n );
+            for( uint32_t i = 0; i < n; ++i )
             {
-                Local<Value> const & k = ar->Get(Integer::New(ndx));
-                if( ! obj->HasRealNamedProperty(k) ) continue;
-                map[CastFromJS<KeyType>(k)] = CastFromJS<ValueType>(obj->Get(k));
+                v8::Handle<v8::Value> const k( keys->Get(i) );
+                Detail::MapInsert( map,
+                                   CastFromJS<KeyType>( k ),
+                                   CastFromJS<ValueType>( obj->Get(k) ) );
             }
+            Detail::FinishMap( map );
             return map;
         }
     };
+
+    /** Partial specialization for std::map<>. */
+    template <typename KeyT,typename ValT>
+    struct JSToNative< std::map<KeyT,ValT> > : JSToNative_map< std::map<KeyT,ValT> > {};
+
+    /**
+       Partial specialization for "flat maps": vectors of (key,value)
+       pairs, sorted by key.
+    */
+    template <typename KeyT,typename ValT>
+    struct JSToNative< std::vector< std::pair<KeyT,ValT> > >
+        : JSToNative_map< std::vector< std::pair<KeyT,ValT> >, KeyT, ValT > {};
+
+#if CVV8_CONFIG_HAS_UNORDERED_MAP
+    /** Partial specialization for std::unordered_map<>. */
+    template <typename KeyT,typename ValT>
+    struct JSToNative< std::unordered_map<KeyT,ValT> > : JSToNative_map< std::unordered_map<KeyT,ValT> > {};
 #endif
     /**
        A utility class for building up message strings, most notably
@@ -1846,10 +2734,17 @@ namespace cvv8 {
 
        Violating any of those leads to undefined behaviour, and
        very possibly memory corruption for cases 2 or 3.
+
+       The conversion does not allocate for strings shorter than
+       InlineSize bytes. Longer ones are stored in a reusable
+       per-thread buffer.
     */
     template <>
     struct ArgCaster<char const *>
     {
+        /** Strings shorter than this many bytes are converted
+            without allocating memory. */
+        enum { InlineSize = 128 };
     private:
         /**
             Reminder to self: we cannot use v8::String::Utf8Value
@@ -1857,7 +2752,7 @@ namespace cvv8 {
             v8 might have been unlocked, at which point dereferencing
             the Utf8Value becomes illegal.
         */
-        std::string val;
+        Detail::StringArgBuffer<InlineSize> val;
         typedef char Type;
     public:
         typedef Type const * ResultType;
@@ -1877,13 +2772,12 @@ namespace cvv8 {
         */
         ResultType ToNative( v8::Handle<v8::Value> const & v )
         {
-            typedef JSToNative<std::string> C;
             if( v.IsEmpty() || v->IsNull() || v->IsUndefined() )
             {
+                this->val.Clear();
                 return 0;
             }
-            this->val = C()( v );
-            return this->val.c_str();
+            return this->val.Assign( v ).data();
         }
         /**
             To eventually be used for some internal optimizations.
@@ -1891,6 +2785,40 @@ namespace cvv8 {
         enum { HasConstOp = 0 };
     };
 
+    /**
+       Specialization for StringView. It works like ArgCaster<char
+       const *>, with the same lifetime rules and limitations, except
+       that:
+
+       - The view carries the string's length, so strings with
+       embedded NUL bytes are supported.
+
+       - null and undefined values are converted to an empty view
+       with a null data() pointer.
+    */
+    template <>
+    struct ArgCaster<StringView>
+    {
+    private:
+        Detail::StringArgBuffer<ArgCaster<char const *>::InlineSize> val;
+    public:
+        typedef StringView ResultType;
+        ResultType ToNative( v8::Handle<v8::Value> const & v )
+        {
+            if( v.IsEmpty() || v->IsNull() || v->IsUndefined() )
+            {
+                this->val.Clear();
+                return StringView();
+            }
+            return this->val.Assign( v );
+        }
+        enum { HasConstOp = 0 };
+    };
+
+    /** Equivalent to ArgCaster<StringView>. */
+    template <>
+    struct ArgCaster<StringView const &> : ArgCaster<StringView> {};
+
 #if !defined(DOXYGEN)
     namespace Detail {
         /**
@@ -1902,7 +2830,7 @@ namespace cvv8 {
         struct CtorForwarderProxy
         {
             typedef typename Signature<Sig>::ReturnType ReturnType;
-            static ReturnType Call( v8::Arguments const & );
+            static ReturnType Call( v8::Arguments const &, void * mem = 0 );
         };
 
         //! Specialization for 0-arity ctors.
@@ -1910,10 +2838,10 @@ namespace cvv8 {
         struct CtorForwarderProxy<Sig,0>
         {
             typedef typename Signature<Sig>::ReturnType ReturnType;
-            static ReturnType Call( v8::Arguments const & )
+            static ReturnType Call( v8::Arguments const &, void * mem = 0 )
             {
                 typedef typename TypeInfo<ReturnType>::Type RType;
-                return new RType;
+                return mem ? new (mem) RType : new RType;
             }
         };
         //! Specialization for ctors taking (v8::Arguments const &).
@@ -1921,10 +2849,10 @@ namespace cvv8 {
         struct CtorForwarderProxy<Sig,-1>
         {
             typedef typename Signature<Sig>::ReturnType ReturnType;
-            static ReturnType Call( v8::Arguments const & argv )
+            static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
             {
                 typedef typename TypeInfo<ReturnType>::Type T;
-                return new T(argv);
+                return mem ? new (mem) T(argv) : new T(argv);
             }
         };
 
@@ -1976,7 +2904,7 @@ namespace cvv8 {
             
             Returns the result of (new Type(...)), transfering ownership
             to the caller.
-            
+
             May propagate native exceptions.
         */
         static ReturnType Call( v8::Arguments const & argv )
@@ -1985,11 +2913,118 @@ namespace cvv8 {
             typedef Detail::CtorForwarderProxy<Sig> Proxy;
             return Proxy::Call( argv );
         }
+        /**
+            Like Call(), but constructs the object in place with
+            (new (mem) Type(...)). mem must point to memory suitably
+            sized and aligned for Type. If the constructor throws, mem
+            is not freed. This is used by ClassCreator_Factory_Pooled.
+        */
+        static ReturnType CallInPlace( void * mem, v8::Arguments const & argv )
+        {
+            typedef Detail::CtorForwarderProxy<Sig> Proxy;
+            return Proxy::Call( argv, mem );
+        }
     };
 
 #if !defined(DOXYGEN)
     namespace Detail
     {
+        /**
+           A jump table which maps an argument count to the function
+           which handles that many arguments, so that arity-based
+           overload dispatching (ArityDispatchList, CtorArityDispatcher)
+           costs one array lookup instead of one comparison per
+           overload.
+
+           Traits must provide:
+
+           - FunctionType: the function pointer type stored in the
+           table.
+
+           - template <int Argc> struct Slot, with a static Call
+           function convertible to FunctionType, which handles calls
+           with exactly Argc arguments.
+
+           - A static Fallback function, convertible to FunctionType,
+           which handles any argument count greater than MaxArgc.
+
+           The table is built entirely at compile time (it is
+           constant-initialized, with no runtime setup).
+        */
+        template <typename Traits>
+        struct ArityJumpTable
+        {
+            typedef typename Traits::FunctionType FunctionType;
+            enum {
+            /** The highest argument count with its own table slot. */
+            MaxArgc = 10,
+            /** The index of the Fallback slot. */
+            FallbackIndex = MaxArgc + 1
+            };
+            static FunctionType const Table[FallbackIndex + 1];
+            /** Returns the table entry for the given argument count. */
+            static FunctionType Lookup( int argc )
+            {
+                return Table[ ((argc >= 0) && (argc <= MaxArgc)) ? argc : FallbackIndex ];
+            }
+        };
+
+        template <typename Traits>
+        typename ArityJumpTable<Traits>::FunctionType const
+        ArityJumpTable<Traits>::Table[ArityJumpTable<Traits>::FallbackIndex + 1] = {
+            &Traits::template Slot<0>::Call,
+            &Traits::template Slot<1>::Call,
+            &Traits::template Slot<2>::Call,
+            &Traits::template Slot<3>::Call,
+            &Traits::template Slot<4>::Call,
+            &Traits::template Slot<5>::Call,
+            &Traits::template Slot<6>::Call,
+            &Traits::template Slot<7>::Call,
+            &Traits::template Slot<8>::Call,
+            &Traits::template Slot<9>::Call,
+            &Traits::template Slot<10>::Call,
+            &Traits::Fallback
+        };
+
+        /**
+           Equivalent to tmp::IfElse, but usable when IF or ELSE is
+           tmp::NilType (which IfElse's typelist-based implementation
+           treats as the end of its list).
+        */
+        template <bool Cond, typename IF, typename ELSE>
+        struct SelectType
+        {
+            typedef IF Type;
+        };
+        template <typename IF, typename ELSE>
+        struct SelectType<false, IF, ELSE>
+        {
+            typedef ELSE Type;
+        };
+
+        /**
+           A metafunction whose Type is the first CtorForwarder in List
+           which accepts Argc arguments (either exactly that many or
+           any number), or tmp::NilType if there is none.
+        */
+        template <typename List, int Argc>
+        struct CtorArityMatch
+        {
+            typedef typename List::Head CTOR;
+            enum { Arity = (0==sl::Index<v8::Arguments const &,CTOR>::Value)
+                            ? -1 : sl::Length<CTOR>::Value
+            };
+            typedef typename SelectType< (Arity < 0) || (Arity == Argc),
+                                         CTOR,
+                                         typename CtorArityMatch<typename List::Tail, Argc>::Type
+                                         >::Type Type;
+        };
+        /** End-of-list specialization. */
+        template <int Argc>
+        struct CtorArityMatch<tmp::NilType, Argc>
+        {
+            typedef tmp::NilType Type;
+        };
 
         /**
            Internal dispatch routine. CTOR _must_ be a CtorForwarder implementation
@@ -2003,6 +3038,10 @@ namespace cvv8 {
             {
                 return CTOR::Call( argv );
             }
+            static ReturnType CallInPlace( void * mem, v8::Arguments const &  argv )
+            {
+                return CTOR::CallInPlace( mem, argv );
+            }
         };
         /**
            Internal dispatch end-of-list routine.
@@ -2015,6 +3054,10 @@ namespace cvv8 {
             {
                 return 0;
             }
+            static ReturnType CallInPlace( void *, v8::Arguments const & )
+            {
+                return 0;
+            }
         };
         /**
            Internal type to dispatch a v8::Arguments list to one of
@@ -2043,6 +3086,18 @@ namespace cvv8 {
                     ? CtorFwdDispatch< T, CTOR >::Call(argv )
                     : CtorFwdDispatchList<T,Tail>::Call(argv);
             }
+            /** In-place variant of Call(). See CtorForwarder::CallInPlace(). */
+            static ReturnType CallInPlace( void * mem, v8::Arguments const &  argv )
+            {
+                typedef typename List::Head CTOR;
+                typedef typename List::Tail Tail;
+                enum { Arity = (0==sl::Index<v8::Arguments const &,CTOR>::Value)
+                                ? -1 : sl::Length<CTOR>::Value
+                };
+                return ( (Arity < 0) || (Arity == argv.Length()) )
+                    ? CtorFwdDispatch< T, CTOR >::CallInPlace( mem, argv )
+                    : CtorFwdDispatchList<T,Tail>::CallInPlace( mem, argv );
+            }
         };
         /**
            End-of-list specialization.
@@ -2059,6 +3114,56 @@ namespace cvv8 {
                 throw std::range_error(msg.Content().c_str());
                 return 0;
             }
+            static ReturnType CallInPlace( void *, v8::Arguments const &  argv )
+            {
+                return Call( argv );
+            }
+        };
+
+        /**
+           ArityJumpTable traits for CtorFwdDispatchList<T,List>::Call().
+           Argument counts with no matching ctor map to the
+           end-of-list handler, as for the linear search.
+        */
+        template <typename T, typename List>
+        struct CtorArityTableTraits
+        {
+            typedef typename TypeInfo<T>::NativeHandle (*FunctionType)( v8::Arguments const & );
+            template <int Argc>
+            struct Slot : SelectType< tmp::IsNil< typename CtorArityMatch<List,Argc>::Type >::Value,
+                                  CtorFwdDispatchList<T,tmp::NilType>,
+                                  CtorFwdDispatch<T, typename CtorArityMatch<List,Argc>::Type>
+                                  >::Type
+            {};
+            static typename TypeInfo<T>::NativeHandle Fallback( v8::Arguments const & argv )
+            {
+                return CtorFwdDispatchList<T,List>::Call( argv );
+            }
+        };
+
+        /**
+           ArityJumpTable traits for CtorFwdDispatchList<T,List>::CallInPlace().
+        */
+        template <typename T, typename List>
+        struct CtorArityTableTraitsInPlace
+        {
+            typedef typename TypeInfo<T>::NativeHandle (*FunctionType)( void *, v8::Arguments const & );
+            template <int Argc>
+            struct Slot
+            {
+                typedef typename SelectType< tmp::IsNil< typename CtorArityMatch<List,Argc>::Type >::Value,
+                                             CtorFwdDispatchList<T,tmp::NilType>,
+                                             CtorFwdDispatch<T, typename CtorArityMatch<List,Argc>::Type>
+                                             >::Type Impl;
+                static typename TypeInfo<T>::NativeHandle Call( void * mem, v8::Arguments const & argv )
+                {
+                    return Impl::CallInPlace( mem, argv );
+                }
+            };
+            static typename TypeInfo<T>::NativeHandle Fallback( void * mem, v8::Arguments const & argv )
+            {
+                return CtorFwdDispatchList<T,List>::CallInPlace( mem, argv );
+            }
         };
     }
 #endif // !DOXYGEN
@@ -2088,7 +3193,9 @@ namespace cvv8 {
         
         The ctors are dispatched based solely on the argument count,
         not their types. The first one with a matching arity
-        is called.
+        is called. The choice is made with a single lookup in a
+        compile-time table indexed by the argument count (see
+        Detail::ArityJumpTable), regardless of the number of ctors.
         
         IN THEORY (untested), the factories passed in the list may 
         legally return a type publically derived from 
@@ -2102,8 +3209,17 @@ namespace cvv8 {
         static NativeHandle Call( v8::Arguments const & argv )
         {
             typedef typename tmp::PlainType<RT>::Type Type;
-            typedef Detail::CtorFwdDispatchList<Type, CtorList> Proxy;
-            return Proxy::Call( argv );
+            typedef Detail::ArityJumpTable< Detail::CtorArityTableTraits<Type, CtorList> > Proxy;
+            return Proxy::Lookup( argv.Length() )( argv );
+        }
+        /**
+            In-place variant of Call(). See CtorForwarder::CallInPlace().
+        */
+        static NativeHandle CallInPlace( void * mem, v8::Arguments const & argv )
+        {
+            typedef typename tmp::PlainType<RT>::Type Type;
+            typedef Detail::ArityJumpTable< Detail::CtorArityTableTraitsInPlace<Type, CtorList> > Proxy;
+            return Proxy::Lookup( argv.Length() )( mem, argv );
         }
     };
 
@@ -0,0 +1,305 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_DEFERRED_DELETE_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_DEFERRED_DELETE_HPP_INCLUDED 1
+/*
+  A queue of native objects whose destruction has been postponed
+  out of the v8 garbage collector's weak-reference callbacks.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include "wall_clock.hpp"
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#if CVV8_CONFIG_HAS_STD_THREAD
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
+namespace cvv8 {
+
+    /**
+       Statistics for DeferredDeleteQueue. All times are in
+       microseconds.
+    */
+    struct DeferredDeleteStats
+    {
+        /** Number of objects currently waiting to be destroyed. */
+        std::size_t Pending;
+        /** The largest value Pending has ever had. */
+        std::size_t MaxPending;
+        /** Total number of objects ever queued. */
+        std::size_t Enqueued;
+        /** Total number of queued objects which have been destroyed. */
+        std::size_t Deleted;
+        /** Number of non-empty drain batches which have been run. */
+        std::size_t Drains;
+        /** Duration of the most recent drain batch. */
+        double LastDrainUs;
+        /** Duration of the longest drain batch. */
+        double MaxDrainUs;
+        /** Sum of the durations of all drain batches. */
+        double TotalDrainUs;
+        DeferredDeleteStats()
+            : Pending(0), MaxPending(0), Enqueued(0), Deleted(0), Drains(0),
+              LastDrainUs(0), MaxDrainUs(0), TotalDrainUs(0)
+        {}
+    };
+
+    /**
+       A process-wide queue of native objects which are to be
+       destroyed "later" instead of from inside a v8 weak-reference
+       callback, where a slow destructor (closing a socket, finalizing
+       a database statement, freeing a large buffer...) stretches the
+       GC pause.
+
+       ClassCreator<T> uses this for types which specialize
+       ClassCreator_DeferredDelete<T>. By the time an object is queued
+       it has already been disconnected from its JS object, so draining
+       the queue only runs native code. Entries are destroyed in the
+       order they were queued.
+
+       Objects queued with threadSafe=false are only destroyed by
+       Drain(), which should be called periodically from the thread
+       which owns the v8 lock, e.g. from an idle hook (the shell-skel
+       addon does this from its gc() function). Objects queued with
+       threadSafe=true may instead be destroyed by a background thread
+       (see StartWorker()), if one is running, or by Drain().
+
+       If objects are queued and never drained, they are leaked.
+       Call Drain(0) before shutting down v8 if that matters.
+    */
+    class DeferredDeleteQueue
+    {
+    public:
+        /** Destroys the object passed to it. */
+        typedef void (*DeleteFunc)( void * );
+
+    private:
+        struct Entry
+        {
+            void * obj;
+            DeleteFunc dtor;
+            Entry( void * o, DeleteFunc d ) : obj(o), dtor(d) {}
+        };
+        typedef std::deque<Entry> QueueT;
+        typedef std::vector<Entry> BatchT;
+
+        struct State
+        {
+            /** Entries which must be destroyed from the v8 thread. */
+            QueueT local;
+            /** Entries which may be destroyed from any thread. */
+            QueueT shared;
+            DeferredDeleteStats stats;
+#if CVV8_CONFIG_HAS_STD_THREAD
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::thread worker;
+            bool stopWorker;
+            State() : local(), shared(), stats(), mutex(), wake(), worker(), stopWorker(false) {}
+#else
+            State() : local(), shared(), stats() {}
+#endif
+        };
+
+        static State & state()
+        {
+            static State bob;
+            return bob;
+        }
+
+#if CVV8_CONFIG_HAS_STD_THREAD
+        typedef std::unique_lock<std::mutex> Lock;
+        static Lock lock() { return Lock( state().mutex ); }
+#else
+        struct Lock {};
+        static Lock lock() { return Lock(); }
+#endif
+
+        /**
+           Moves up to max (0=all) entries from q to dest. Caller must
+           hold the lock.
+        */
+        static void take( QueueT & q, BatchT & dest, std::size_t max )
+        {
+            for( std::size_t n = 0; !q.empty() && (!max || (n < max)); ++n )
+            {
+                dest.push_back( q.front() );
+                q.pop_front();
+            }
+        }
+
+        /**
+           Destroys all entries in batch and records it in the
+           statistics. Must not be called while holding the lock.
+        */
+        static std::size_t run( BatchT const & batch )
+        {
+            if( batch.empty() ) return 0;
+            double const start = Detail::WallClockUs();
+            BatchT::const_iterator it = batch.begin();
+            for( ; batch.end() != it; ++it ) it->dtor( it->obj );
+            double const us = Detail::WallClockUs() - start;
+            Lock const lk( lock() );
+            DeferredDeleteStats & st( state().stats );
+            st.Pending -= batch.size();
+            st.Deleted += batch.size();
+            ++st.Drains;
+            st.LastDrainUs = us;
+            st.TotalDrainUs += us;
+            if( us > st.MaxDrainUs ) st.MaxDrainUs = us;
+            return batch.size();
+        }
+
+#if CVV8_CONFIG_HAS_STD_THREAD
+        static void workerMain( std::size_t batchSize )
+        {
+            State & s( state() );
+            BatchT batch;
+            batch.reserve( batchSize );
+            for( ;; )
+            {
+                {
+                    Lock lk( lock() );
+                    while( !s.stopWorker && s.shared.empty() ) s.wake.wait( lk );
+                    if( s.shared.empty() ) return /* stopWorker is set */;
+                    take( s.shared, batch, batchSize );
+                }
+                run( batch );
+                batch.clear();
+            }
+        }
+#endif
+
+    public:
+        /**
+           Queues obj to be destroyed later by passing it to dtor. If
+           threadSafe is true then dtor(obj) may be called from a
+           thread which does not hold the v8 lock.
+
+           Does nothing if obj is 0.
+        */
+        static void Enqueue( void * obj, DeleteFunc dtor, bool threadSafe )
+        {
+            if( !obj ) return;
+            State & s( state() );
+            Lock const lk( lock() );
+            (threadSafe ? s.shared : s.local).push_back( Entry( obj, dtor ) );
+            ++s.stats.Enqueued;
+            if( ++s.stats.Pending > s.stats.MaxPending ) s.stats.MaxPending = s.stats.Pending;
+#if CVV8_CONFIG_HAS_STD_THREAD
+            if( threadSafe ) s.wake.notify_one();
+#endif
+        }
+
+        /**
+           Destroys up to maxCount queued objects (all of them if
+           maxCount is 0), oldest first, and returns the number
+           destroyed. Objects which are not thread-safe are taken
+           before thread-safe ones.
+
+           Must be called from the thread which holds the v8 lock
+           (the destructors are native code, but they are the same
+           destructors which would otherwise have run inside the GC,
+           and may assume they run on that thread).
+
+           If a destructor throws, the exception propagates and the
+           rest of that batch is leaked.
+        */
+        static std::size_t Drain( std::size_t maxCount = 0 )
+        {
+            State & s( state() );
+            BatchT batch;
+            {
+                Lock const lk( lock() );
+                take( s.local, batch, maxCount );
+                if( !maxCount || (batch.size() < maxCount) )
+                {
+                    take( s.shared, batch, maxCount ? (maxCount - batch.size()) : 0 );
+                }
+            }
+            return run( batch );
+        }
+
+        /** Returns the number of objects waiting to be destroyed. */
+        static std::size_t Pending()
+        {
+            Lock const lk( lock() );
+            return state().stats.Pending;
+        }
+
+        /** Returns a snapshot of the current statistics. */
+        static DeferredDeleteStats Stats()
+        {
+            Lock const lk( lock() );
+            return state().stats;
+        }
+
+        /**
+           Starts a background thread which destroys objects queued
+           with threadSafe=true as they arrive, in batches of at most
+           batchSize objects. Returns false if the worker is already
+           running or if this build has no thread support
+           (CVV8_CONFIG_HAS_STD_THREAD is 0), in which case such objects
+           are destroyed by Drain() instead.
+
+           StopWorker() must be called before the application exits.
+        */
+        static bool StartWorker( std::size_t batchSize = 64 )
+        {
+#if CVV8_CONFIG_HAS_STD_THREAD
+            State & s( state() );
+            Lock const lk( lock() );
+            if( s.worker.joinable() ) return false;
+            s.stopWorker = false;
+            s.worker = std::thread( workerMain, batchSize ? batchSize : 1 );
+            return true;
+#else
+            (void)batchSize;
+            return false;
+#endif
+        }
+
+        /**
+           Stops the thread started by StartWorker(), after it has
+           destroyed all thread-safe objects queued so far. Does
+           nothing if the worker is not running.
+        */
+        static void StopWorker()
+        {
+#if CVV8_CONFIG_HAS_STD_THREAD
+            State & s( state() );
+            {
+                Lock const lk( lock() );
+                if( !s.worker.joinable() ) return;
+                s.stopWorker = true;
+                s.wake.notify_one();
+            }
+            s.worker.join();
+#endif
+        }
+
+        /**
+           A v8::InvocationCallback with the JS interface:
+
+           @code
+           int drainDeferredDeletes([int maxCount=0])
+           @endcode
+
+           which calls Drain(maxCount) and returns the number of
+           objects destroyed.
+        */
+        static v8::Handle<v8::Value> DrainCallback( v8::Arguments const & argv )
+        {
+            int32_t const max = (argv.Length() > 0) ? argv[0]->Int32Value() : 0;
+            std::size_t const n = Drain( (max > 0) ? static_cast<std::size_t>(max) : 0 );
+            return v8::Integer::NewFromUnsigned( static_cast<uint32_t>(n) );
+        }
+    };
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_DEFERRED_DELETE_HPP_INCLUDED */
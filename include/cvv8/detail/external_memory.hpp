@@ -0,0 +1,219 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_EXTERNAL_MEMORY_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_EXTERNAL_MEMORY_HPP_INCLUDED 1
+/*
+  Reporting of the native memory held by JS-bound objects to v8's
+  garbage collector, with per-type totals. The ClassCreator policy
+  which enables it, ClassCreator_ExternalMemory, lives in
+  ClassCreator.hpp.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include "ptr_hash_map.hpp"
+#include "stats_mutex.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace cvv8 {
+
+    /**
+       External (native) memory statistics for one bound type. See
+       ExternalMemory.
+    */
+    struct ExternalMemoryStats
+    {
+        /** The type's name (TypeName<T>::Value). */
+        char const * Name;
+        /** Number of currently wrapped objects. */
+        std::size_t Objects;
+        /** Bytes currently reported to v8 for those objects. */
+        std::size_t Bytes;
+        /** The largest value Bytes has ever had. */
+        std::size_t PeakBytes;
+        ExternalMemoryStats()
+            : Name(0), Objects(0), Bytes(0), PeakBytes(0)
+        {}
+    };
+
+    /**
+       The registry of the external memory totals of all types whose
+       ClassCreator_ExternalMemory policy is enabled. A type appears
+       here once its first object has been wrapped.
+
+       Mutex(), Records() and Stats() come from
+       Detail::StatsRegistry.
+    */
+    class ExternalMemory : public Detail::StatsRegistry<ExternalMemoryStats>
+    {
+    public:
+        /** Returns the sum of the Bytes of all records. */
+        static std::size_t TotalBytes()
+        {
+            Detail::StatsLock const lk( Mutex() );
+            ListType const & li( Records() );
+            std::size_t rc = 0;
+            ListType::const_iterator it = li.begin();
+            for( ; li.end() != it; ++it ) rc += (*it)->Bytes;
+            return rc;
+        }
+
+        /**
+           Returns all records as a JS array of objects with the
+           properties (name, objects, bytes, peakBytes).
+        */
+        static v8::Handle<v8::Array> ToJS()
+        {
+            std::vector<ExternalMemoryStats> const li( Stats() );
+            v8::HandleScope hsc;
+            v8::Handle<v8::Array> ar( v8::Array::New( static_cast<int>(li.size()) ) );
+            for( uint32_t i = 0; i < li.size(); ++i )
+            {
+                ExternalMemoryStats const & st( li[i] );
+                v8::Handle<v8::Object> o( v8::Object::New() );
+                o->Set( CVV8_SYMBOL("name"), v8::String::New( st.Name ) );
+                o->Set( CVV8_SYMBOL("objects"), v8::Number::New( static_cast<double>(st.Objects) ) );
+                o->Set( CVV8_SYMBOL("bytes"), v8::Number::New( static_cast<double>(st.Bytes) ) );
+                o->Set( CVV8_SYMBOL("peakBytes"), v8::Number::New( static_cast<double>(st.PeakBytes) ) );
+                ar->Set( i, o );
+            }
+            return hsc.Close( ar );
+        }
+
+        /**
+           v8::InvocationCallback which returns ToJS().
+        */
+        static v8::Handle<v8::Value> StatsCallback( v8::Arguments const & )
+        {
+            return ToJS();
+        }
+    };
+
+#if !defined(DOXYGEN)
+namespace Detail {
+    /**
+       Tracks the bytes reported to v8 for each wrapped T. The amount
+       reported for each object is remembered, so that exactly that
+       much is given back when it is unwrapped, however its size
+       changed in between, and so that size changes of objects which
+       are not (or not yet) wrapped are ignored.
+
+       If Enabled is false all functions are no-ops.
+    */
+    template <typename T, bool Enabled>
+    class ExternalMemoryTracker
+    {
+    private:
+        struct State
+        {
+            ExternalMemoryStats stats;
+            PtrHashMap<std::size_t> objects;
+            State() : stats(), objects()
+            {
+                stats.Name = TypeName<T>::Value;
+                StatsLock const lk( ExternalMemory::Mutex() );
+                ExternalMemory::Records().push_back( &stats );
+            }
+        };
+
+        static State & state()
+        {
+            static State bob;
+            return bob;
+        }
+
+        /**
+           Updates the totals for a change from oldBytes to newBytes
+           and returns the difference, to be passed to report(). The
+           caller must hold ExternalMemory::Mutex().
+        */
+        static long account( State & s, std::size_t oldBytes, std::size_t newBytes )
+        {
+            s.stats.Bytes = s.stats.Bytes - oldBytes + newBytes;
+            if( s.stats.Bytes > s.stats.PeakBytes ) s.stats.PeakBytes = s.stats.Bytes;
+            return static_cast<long>(newBytes) - static_cast<long>(oldBytes);
+        }
+
+        /**
+           Reports a change computed by account() to v8. This may run
+           a GC, whose weak callbacks may unwrap (i.e. call
+           Unwrapped() for) other objects, so it must not be called
+           with ExternalMemory::Mutex() held, nor while holding a
+           pointer into State::objects.
+        */
+        static void report( long delta )
+        {
+            if( delta ) v8::V8::AdjustAmountOfExternalAllocatedMemory( static_cast<int>(delta) );
+        }
+
+    public:
+        /** Starts tracking obj, which holds the given number of bytes. */
+        static void Wrapped( T const * obj, std::size_t bytes )
+        {
+            State & s( state() );
+            long delta;
+            {
+                StatsLock const lk( ExternalMemory::Mutex() );
+                std::size_t * const old = s.objects.Find( obj );
+                if( old )
+                {
+                    delta = account( s, *old, bytes );
+                    *old = bytes;
+                }
+                else
+                {
+                    s.objects.Insert( obj, bytes );
+                    ++s.stats.Objects;
+                    delta = account( s, 0, bytes );
+                }
+            }
+            report( delta );
+        }
+
+        /**
+           Changes the amount reported for obj to bytes. Does nothing
+           if obj is not being tracked.
+        */
+        static void Resized( T const * obj, std::size_t bytes )
+        {
+            State & s( state() );
+            long delta;
+            {
+                StatsLock const lk( ExternalMemory::Mutex() );
+                std::size_t * const old = s.objects.Find( obj );
+                if( !old ) return;
+                delta = account( s, *old, bytes );
+                *old = bytes;
+            }
+            report( delta );
+        }
+
+        /** Stops tracking obj and releases the amount reported for it. */
+        static void Unwrapped( T const * obj )
+        {
+            State & s( state() );
+            long delta;
+            {
+                StatsLock const lk( ExternalMemory::Mutex() );
+                std::size_t bytes = 0;
+                if( !s.objects.Erase( obj, &bytes ) ) return;
+                --s.stats.Objects;
+                delta = account( s, bytes, 0 );
+            }
+            report( delta );
+        }
+    };
+
+    template <typename T>
+    class ExternalMemoryTracker<T, false>
+    {
+    public:
+        static void Wrapped( T const *, std::size_t ) {}
+        static void Resized( T const *, std::size_t ) {}
+        static void Unwrapped( T const * ) {}
+    };
+}
+#endif /* DOXYGEN */
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_EXTERNAL_MEMORY_HPP_INCLUDED */
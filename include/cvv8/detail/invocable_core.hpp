@@ -14,6 +14,13 @@ conversion.
 
 #include "convert_core.hpp"
 #include "signature_core.hpp"
+#include "profiler.hpp"
+#include "lock_stats.hpp"
+#include "adaptive_unlock.hpp"
+#include "stats_mutex.hpp"
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+#  include <type_traits>
+#endif
 
 namespace cvv8 {
 
@@ -131,15 +138,77 @@ namespace Detail {
     /**
         A sentry class which instantiates a v8::Unlocker
         if the boolean value is true or is a no-op if it is false.
+
+        Forwarders pass the native function they are about to call,
+        which identifies them to InCaAdaptiveUnlock.
     */
-    template <bool> struct V8Unlocker {};
+    template <bool> struct V8Unlocker
+    {
+        V8Unlocker() {}
+        template <typename F>
+        explicit V8Unlocker( F const & ) {}
+    };
     
     /**
-        Equivalent to v8::Unlocker.
+        Equivalent to v8::Unlocker, except that it does nothing if
+        v8::Locker is not in use (unlocking is then not legal), and
+        that it records the unlocked time in LockStats (if that is
+        enabled).
+
+        If it is created for the native function of an active
+        InCaAdaptiveUnlock call, that decides whether it unlocks, and
+        it reports the duration of its lifetime (i.e. of the native
+        call) back.
     */
     template <>
-    struct V8Unlocker<true> : v8::Unlocker
+    struct V8Unlocker<true>
     {
+    private:
+        V8UnlockTimer timer;
+        AdaptiveUnlockFrame * const adaptive;
+        double start;
+        union
+        {
+            void * align;
+            char mem[sizeof(v8::Unlocker)];
+        } storage;
+        v8::Unlocker * unlocker;
+        V8Unlocker( V8Unlocker const & );
+        V8Unlocker & operator=( V8Unlocker const & );
+        /** Unlocks if adaptive allows it and v8::Locker is in use. */
+        v8::Unlocker * unlock()
+        {
+            if( adaptive && adaptive->measure ) start = AdaptiveUnlockNowUs();
+            if( (adaptive && !adaptive->unlock) || !v8::Locker::IsActive() ) return 0;
+#if CVV8_CONFIG_HAS_ISOLATE_LOCKING
+            v8::Unlocker * const u = new (storage.mem) v8::Unlocker( v8::Isolate::GetCurrent() );
+#else
+            v8::Unlocker * const u = new (storage.mem) v8::Unlocker;
+#endif
+            timer.Unlocked();
+            return u;
+        }
+    public:
+        V8Unlocker()
+            : timer(), adaptive( 0 ), start( 0 ), storage(), unlocker( unlock() )
+        {}
+        /**
+            Like the default constructor, but claims the active
+            InCaAdaptiveUnlock call if func is its native function.
+        */
+        template <typename F>
+        explicit V8Unlocker( F const & func )
+            : timer(), adaptive( AdaptiveUnlockFrame::Claim( func ) ), start( 0 ),
+              storage(), unlocker( unlock() )
+        {}
+        ~V8Unlocker()
+        {
+            if( adaptive && adaptive->measure ) adaptive->bodyUs = AdaptiveUnlockNowUs() - start;
+            if( !unlocker ) return;
+            timer.Relocking();
+            unlocker->~Unlocker();
+            timer.Relocked();
+        }
     };
     
 
@@ -438,7 +507,8 @@ namespace Detail {
         typedef typename SignatureType::FunctionType FunctionType;
         static ReturnType CallNative( FunctionType func, v8::Arguments const & )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return func();
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -461,7 +531,8 @@ namespace Detail {
         typedef Sig FunctionType;
         static ReturnType CallNative( FunctionType func, v8::Arguments const & )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)func()
             /* the explicit cast there is a workaround for the RV==void
                case. It is a no-op for other cases, since the return value
@@ -488,7 +559,8 @@ namespace Detail {
         typedef typename SignatureType::ReturnType ReturnType;
         static ReturnType CallNative( FunctionType func, v8::Arguments const & argv )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)func(argv);
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -519,7 +591,8 @@ namespace Detail {
         typedef typename TypeInfo<T>::Type Type;
         static ReturnType CallNative( T & self, FunctionType func, v8::Arguments const & argv )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (self.*func)();
         }
         static v8::Handle<v8::Value> Call( T & self, FunctionType func, v8::Arguments const & argv )
@@ -607,7 +680,8 @@ namespace Detail {
         typedef typename SignatureType::ReturnType ReturnType;
         static ReturnType CallNative( Type & self, FunctionType func, v8::Arguments const & )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)();
         }
         static v8::Handle<v8::Value> Call( Type & self, FunctionType func, v8::Arguments const & argv )
@@ -699,7 +773,8 @@ namespace Detail {
         typedef typename SignatureType::ReturnType ReturnType;
         static ReturnType CallNative( T const & self, FunctionType func, v8::Arguments const & )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (self.*func)();
         }
         
@@ -785,7 +860,8 @@ namespace Detail {
         typedef typename TypeInfo<T>::Type Type;
         static ReturnType CallNative( Type const & self, FunctionType func, v8::Arguments const & )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)();
         }
         
@@ -828,7 +904,8 @@ namespace Detail {
         typedef typename TypeInfo<T>::Type Type;
         static ReturnType CallNative( Type const & self, FunctionType func, v8::Arguments const & argv )
         {
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)();
         }
         static v8::Handle<v8::Value> Call( Type const & self, FunctionType func, v8::Arguments const & argv )
@@ -963,11 +1040,33 @@ public:
     converts native arguments to JS and calls a JS function.
 
     The default implementation is useless - it must be specialized
-    for each arity.
+    for each arity - unless CVV8_CONFIG_HAS_VARIADIC_TEMPLATES is true,
+    in which case it handles all arities except 0.
 */
 template <int Arity>
 struct CallForwarder
 {
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+    template <typename... Args>
+    static typename std::enable_if< (Arity == sizeof...(Args)), v8::Handle<v8::Value> >::type
+    Call( v8::Handle<v8::Object> const & self,
+          v8::Handle<v8::Function> const & func,
+          Args... args )
+    {
+        v8::Handle<v8::Value> argv[] = {
+            CastToJS(args)...
+        };
+        return (self.IsEmpty() || func.IsEmpty())
+            ? Toss("Illegal argument: empty v8::Handle<>.")
+            : func->Call(self, sizeof(argv)/sizeof(argv[0]), argv);
+    }
+    template <typename... Args>
+    static typename std::enable_if< (Arity == sizeof...(Args)), v8::Handle<v8::Value> >::type
+    Call( v8::Handle<v8::Function> const & func, Args... args )
+    {
+        return Call( v8::Handle<v8::Object>(func), func, args... );
+    }
+#else
     /**
         Implementations must be templates taking Arity arguments in addition
         to the first two. All argument types must legal for use with
@@ -988,6 +1087,7 @@ struct CallForwarder
         Call(func,func,...).
     */
     static v8::Handle<v8::Value> Call( v8::Handle<v8::Function> const & func, ... );
+#endif
 };
 
 //! Specialization for 0-arity calls.
@@ -1865,6 +1965,198 @@ struct InCaCatcher_std :
                 >
 {};
 
+/**
+   An InCa decorator which records call statistics for InCaT in
+   the CallProfiler registry, under the name TypeName<NameT>::Value.
+   NameT is normally an otherwise unused tag type, declared with
+   CVV8_TypeName_DECL/CVV8_TypeName_IMPL:
+
+   @code
+   struct Prof_Foo_doBar {};
+   CVV8_TypeName_DECL((Prof_Foo_doBar));   // in a header
+   CVV8_TypeName_IMPL((Prof_Foo_doBar),"Foo.doBar"); // in one .cpp
+
+   typedef MethodToInCa<Foo, int (int), &Foo::doBar> DoBar;
+   proto->Set( "doBar", FunctionTemplate::New(
+       InCaProfiler<DoBar, Prof_Foo_doBar>::Call )->GetFunction() );
+   @endcode
+
+   If CVV8_CONFIG_ENABLE_PROFILER is false (the default), Call() is
+   exactly InCaT::Call() and TypeName<NameT> is not used. If it
+   is true then each call costs two clock reads, plus two more if
+   InCaT is a converting forwarder, which can split the time
+   between argument/result conversion and the native body (see
+   CallProfileStats::BodyUs).
+
+   Exceptions propagate unchanged, and calls which throw are
+   recorded like any other. Calls must be made with the v8 lock held,
+   as usual. The records themselves are guarded by
+   CallProfiler::Mutex(), so bindings may be profiled in several
+   isolates at once (see V8ShellPool).
+*/
+template <typename InCaT, typename NameT>
+struct InCaProfiler : InCa
+{
+#if CVV8_CONFIG_ENABLE_PROFILER
+private:
+    /** The record, registered with CallProfiler on first use. */
+    struct Record
+    {
+        CallProfileStats stats;
+        Record() : stats()
+        {
+            stats.Name = TypeName<NameT>::Value;
+            Detail::StatsLock const lk( CallProfiler::Mutex() );
+            CallProfiler::Records().push_back( &stats );
+        }
+    };
+    static CallProfileStats & record()
+    {
+        static Record bob;
+        return bob.stats;
+    }
+
+    /** Pushes/pops a ProfileFrame and updates the record. */
+    struct Scope
+    {
+        Detail::ProfileFrame frame;
+        double start;
+        Scope() : start(0)
+        {
+            Detail::ProfileFrame *& cur( Detail::ProfileFrame::Current() );
+            frame.prev = cur;
+            frame.depth = 0;
+            frame.marks = 0;
+            frame.bodyStart = frame.bodyUs = frame.unlockedUs = 0;
+            cur = &frame;
+            start = Detail::ProfilerNowUs();
+        }
+        ~Scope()
+        {
+            double const us = Detail::ProfilerNowUs() - start;
+            Detail::ProfileFrame::Current() = frame.prev;
+            CallProfileStats & st( record() );
+            Detail::StatsLock const lk( CallProfiler::Mutex() );
+            ++st.Calls;
+            st.TotalUs += us;
+            if( us > st.MaxUs ) st.MaxUs = us;
+            st.BodyUs += frame.marks ? frame.bodyUs : us;
+            st.UnlockedUs += frame.unlockedUs;
+        }
+    };
+public:
+    static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
+    {
+        Scope const sc;
+        return InCaT::Call( argv );
+    }
+#else
+    static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
+    {
+        return InCaT::Call( argv );
+    }
+#endif
+};
+
+/**
+   An InCa decorator which makes InCaT unlock v8 only if its native
+   calls are slow enough for unlocking to pay off, as opposed to
+   around every call. InCaT must be a forwarder with a FunctionType
+   and Function (e.g. FunctionToInCa, MethodToInCa or
+   FunctionToBatchInCa) whose UnlockV8 option is true. For short natives, releasing and
+   re-acquiring the lock costs more than the call itself, especially
+   when other threads are waiting for it.
+
+   It keeps a moving average of the duration of the bound native
+   function (argument and result conversions excluded) and stops
+   unlocking when that falls below AdaptiveUnlock::LockBelowUs(), and
+   starts again when it rises above AdaptiveUnlock::UnlockAboveUs().
+   New bindings start out unlocking.
+
+   @code
+   typedef FunctionToInCa<std::string (std::string const &), readFile> ReadFile;
+   global->Set( v8::String::New("readFile"), v8::FunctionTemplate::New(
+       InCaAdaptiveUnlock<ReadFile>::Call )->GetFunction() );
+   @endcode
+
+   Only the call of InCaT::Function is adapted and measured. Other
+   UnlockV8 bindings called meanwhile (e.g. a JS getter bound to a
+   native, invoked while converting the arguments) unlock as usual. As
+   with the rest of the API, calls must be made with the v8 lock held.
+*/
+template <typename InCaT>
+struct InCaAdaptiveUnlock : InCa
+{
+private:
+    /**
+       Shared by all threads (and isolates) calling the binding. The
+       fast path only touches the atomic calls and unlock. The
+       average is updated under mutex, which only measured calls
+       take.
+    */
+    struct State
+    {
+        Detail::StatsMutex mutex;
+        double avgUs;
+        unsigned samples;
+        typename Detail::StatsAtomic<unsigned>::Type calls;
+        typename Detail::StatsAtomic<bool>::Type unlock;
+        State() : mutex(), avgUs(0), samples(0), calls(0), unlock(true) {}
+    };
+    static State & state()
+    {
+        static State bob;
+        return bob;
+    }
+
+    /** Pushes/pops an AdaptiveUnlockFrame and updates the state. */
+    struct Scope
+    {
+        Detail::AdaptiveUnlockFrame frame;
+        explicit Scope( State & s )
+        {
+            Detail::AdaptiveUnlockFrame *& cur( Detail::AdaptiveUnlockFrame::Current() );
+            frame.prev = cur;
+            frame.funcType = &Detail::AdaptiveUnlockFuncType<typename InCaT::FunctionType>::Tag;
+            frame.func = &InCaT::Function;
+            frame.unlock = s.unlock;
+            frame.measure = s.unlock || (0 == (++s.calls % AdaptiveUnlock::SampleInterval));
+            frame.used = false;
+            frame.bodyUs = -1;
+            cur = &frame;
+        }
+        ~Scope()
+        {
+            Detail::AdaptiveUnlockFrame::Current() = frame.prev;
+            if( frame.bodyUs < 0 ) return;
+            State & s( state() );
+            double const us = frame.bodyUs;
+            Detail::StatsLock const lk( s.mutex );
+            s.avgUs = s.samples++ ? (s.avgUs + (us - s.avgUs) / 8) : us;
+            if( s.unlock && (s.avgUs < AdaptiveUnlock::LockBelowUs()) ) s.unlock = false;
+            else if( !s.unlock && (s.avgUs > AdaptiveUnlock::UnlockAboveUs()) ) s.unlock = true;
+        }
+    };
+public:
+    static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
+    {
+        Scope const sc( state() );
+        return InCaT::Call( argv );
+    }
+    /** Returns true if the next call will unlock v8. */
+    static bool Unlocking()
+    {
+        return state().unlock;
+    }
+    /** Returns the moving average of the native call durations, in microseconds. */
+    static double AverageUs()
+    {
+        State & s( state() );
+        Detail::StatsLock const lk( s.mutex );
+        return s.avgUs;
+    }
+};
+
 namespace Detail {
     /**
         An internal level of indirection for overloading-related
@@ -1889,6 +2181,69 @@ namespace Detail {
                         <<argv.Length() );
         }
     };
+
+    /**
+       Linear-search implementation of ArityDispatchList: tests each
+       entry of FwdList in order until one accepts argv.Length()
+       arguments. ArityDispatchList uses this only for argument
+       counts too large for its jump table.
+    */
+    template <typename FwdList>
+    struct ArityDispatchChain : InCa
+    {
+        inline static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
+        {
+            typedef typename FwdList::Head FWD;
+            typedef typename FwdList::Tail Tail;
+            enum { Arity = sl::Arity< FWD >::Value };
+            return ( (-1 == Arity) || (Arity == argv.Length()) )
+                ? OverloadCallHelper<FWD>::Call(argv)
+                : ArityDispatchChain<Tail>::Call(argv);
+        }
+    };
+    //! End-of-list specialization.
+    template <>
+    struct ArityDispatchChain<tmp::NilType> : OverloadCallHelper<tmp::NilType>
+    {
+    };
+
+    /**
+       A metafunction whose Type is the first entry in FwdList which
+       accepts Argc arguments (either exactly that many or any
+       number), or tmp::NilType if there is none.
+    */
+    template <typename FwdList, int Argc>
+    struct InCaArityMatch
+    {
+        typedef typename FwdList::Head FWD;
+        enum { Arity = sl::Arity< FWD >::Value };
+        typedef typename SelectType< (-1 == Arity) || (Arity == Argc),
+                                     FWD,
+                                     typename InCaArityMatch<typename FwdList::Tail, Argc>::Type
+                                     >::Type Type;
+    };
+    //! End-of-list specialization.
+    template <int Argc>
+    struct InCaArityMatch<tmp::NilType, Argc>
+    {
+        typedef tmp::NilType Type;
+    };
+
+    /**
+       ArityJumpTable traits for ArityDispatchList<FwdList>.
+    */
+    template <typename FwdList>
+    struct InCaArityTableTraits
+    {
+        typedef v8::InvocationCallback FunctionType;
+        template <int Argc>
+        struct Slot : OverloadCallHelper< typename InCaArityMatch<FwdList,Argc>::Type >
+        {};
+        static v8::Handle<v8::Value> Fallback( v8::Arguments const & argv )
+        {
+            return ArityDispatchChain<FwdList>::Call( argv );
+        }
+    };
 }
 
 /**
@@ -1937,15 +2292,15 @@ struct ArityDispatchList : InCa
        the Arity 
 
        Implements the v8::InvocationCallback interface.
+
+       The target is found with a single lookup in a compile-time
+       table indexed by argv.Length() (see Detail::ArityJumpTable),
+       so the cost does not grow with the number of overloads.
     */
     inline static v8::Handle<v8::Value> Call( v8::Arguments const & argv )
     {
-        typedef typename FwdList::Head FWD;
-        typedef typename FwdList::Tail Tail;
-        enum { Arity = sl::Arity< FWD >::Value };
-        return ( (-1 == Arity) || (Arity == argv.Length()) )
-            ? Detail::OverloadCallHelper<FWD>::Call(argv)
-            : ArityDispatchList<Tail>::Call(argv);
+        typedef Detail::ArityJumpTable< Detail::InCaArityTableTraits<FwdList> > Table;
+        return Table::Lookup( argv.Length() )( argv );
     }
 };
 
@@ -2193,7 +2548,11 @@ template <typename T, typename Sig, typename MethodSignature<T,Sig>::FunctionTyp
 struct NativeToJS< ToInCaVoid<T, Sig, Func> > : NativeToJS_InCa_Base {};
 #endif
 
-#include "invocable_generated.hpp"
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+#  include "invocable_variadic.hpp"
+#else
+#  include "invocable_generated.hpp"
+#endif
 } // namespace
 
 #undef HANDLE_PROPAGATE_EXCEPTION
@@ -16,7 +16,8 @@ namespace Detail {
 		
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -40,7 +41,8 @@ namespace Detail {
 		
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -66,7 +68,8 @@ namespace Detail {
 		
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -102,7 +105,8 @@ namespace Detail {
 		
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -147,7 +151,8 @@ namespace Detail {
 		
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -183,7 +188,8 @@ namespace Detail {
 		
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -244,7 +250,7 @@ struct CtorForwarderProxy<Sig,1>
 {
     enum { Arity = 1 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -259,7 +265,7 @@ struct CtorForwarderProxy<Sig,1>
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0 );
+            return mem ? new (mem) Type(  arg0 ) : new Type(  arg0 );
         }
     }
 };
@@ -283,7 +289,8 @@ namespace Detail {
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -310,7 +317,8 @@ namespace Detail {
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -339,7 +347,8 @@ namespace Detail {
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -378,7 +387,8 @@ namespace Detail {
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -426,7 +436,8 @@ namespace Detail {
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -465,7 +476,8 @@ namespace Detail {
              AC0 ac0; A0 arg0(ac0.ToNative(argv[0]));
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -526,7 +538,7 @@ struct CtorForwarderProxy<Sig,2>
 {
     enum { Arity = 2 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -544,7 +556,7 @@ struct CtorForwarderProxy<Sig,2>
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1 );
+            return mem ? new (mem) Type(  arg0, arg1 ) : new Type(  arg0, arg1 );
         }
     }
 };
@@ -571,7 +583,8 @@ namespace Detail {
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -601,7 +614,8 @@ namespace Detail {
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -633,7 +647,8 @@ namespace Detail {
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -675,7 +690,8 @@ namespace Detail {
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -726,7 +742,8 @@ namespace Detail {
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -768,7 +785,8 @@ namespace Detail {
 		 AC1 ac1; A1 arg1(ac1.ToNative(argv[1]));
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -829,7 +847,7 @@ struct CtorForwarderProxy<Sig,3>
 {
     enum { Arity = 3 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -850,7 +868,7 @@ struct CtorForwarderProxy<Sig,3>
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2 ) : new Type(  arg0, arg1, arg2 );
         }
     }
 };
@@ -880,7 +898,8 @@ namespace Detail {
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -913,7 +932,8 @@ namespace Detail {
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -948,7 +968,8 @@ namespace Detail {
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -993,7 +1014,8 @@ namespace Detail {
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -1047,7 +1069,8 @@ namespace Detail {
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -1092,7 +1115,8 @@ namespace Detail {
 		 AC2 ac2; A2 arg2(ac2.ToNative(argv[2]));
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -1153,7 +1177,7 @@ struct CtorForwarderProxy<Sig,4>
 {
     enum { Arity = 4 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -1177,7 +1201,7 @@ struct CtorForwarderProxy<Sig,4>
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2, arg3 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2, arg3 ) : new Type(  arg0, arg1, arg2, arg3 );
         }
     }
 };
@@ -1210,7 +1234,8 @@ namespace Detail {
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -1246,7 +1271,8 @@ namespace Detail {
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -1284,7 +1310,8 @@ namespace Detail {
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -1332,7 +1359,8 @@ namespace Detail {
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -1389,7 +1417,8 @@ namespace Detail {
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -1437,7 +1466,8 @@ namespace Detail {
 		 AC3 ac3; A3 arg3(ac3.ToNative(argv[3]));
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -1498,7 +1528,7 @@ struct CtorForwarderProxy<Sig,5>
 {
     enum { Arity = 5 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -1525,7 +1555,7 @@ struct CtorForwarderProxy<Sig,5>
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2, arg3, arg4 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2, arg3, arg4 ) : new Type(  arg0, arg1, arg2, arg3, arg4 );
         }
     }
 };
@@ -1561,7 +1591,8 @@ namespace Detail {
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -1600,7 +1631,8 @@ namespace Detail {
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -1641,7 +1673,8 @@ namespace Detail {
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -1692,7 +1725,8 @@ namespace Detail {
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -1752,7 +1786,8 @@ namespace Detail {
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -1803,7 +1838,8 @@ namespace Detail {
 		 AC4 ac4; A4 arg4(ac4.ToNative(argv[4]));
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -1864,7 +1900,7 @@ struct CtorForwarderProxy<Sig,6>
 {
     enum { Arity = 6 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -1894,7 +1930,7 @@ struct CtorForwarderProxy<Sig,6>
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2, arg3, arg4, arg5 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2, arg3, arg4, arg5 ) : new Type(  arg0, arg1, arg2, arg3, arg4, arg5 );
         }
     }
 };
@@ -1933,7 +1969,8 @@ namespace Detail {
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -1975,7 +2012,8 @@ namespace Detail {
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -2019,7 +2057,8 @@ namespace Detail {
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -2073,7 +2112,8 @@ namespace Detail {
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -2136,7 +2176,8 @@ namespace Detail {
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -2190,7 +2231,8 @@ namespace Detail {
 		 AC5 ac5; A5 arg5(ac5.ToNative(argv[5]));
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -2251,7 +2293,7 @@ struct CtorForwarderProxy<Sig,7>
 {
     enum { Arity = 7 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -2284,7 +2326,7 @@ struct CtorForwarderProxy<Sig,7>
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 ) : new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6 );
         }
     }
 };
@@ -2326,7 +2368,8 @@ namespace Detail {
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -2371,7 +2414,8 @@ namespace Detail {
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -2418,7 +2462,8 @@ namespace Detail {
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -2475,7 +2520,8 @@ namespace Detail {
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -2541,7 +2587,8 @@ namespace Detail {
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -2598,7 +2645,8 @@ namespace Detail {
 		 AC6 ac6; A6 arg6(ac6.ToNative(argv[6]));
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -2659,7 +2707,7 @@ struct CtorForwarderProxy<Sig,8>
 {
     enum { Arity = 8 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -2695,7 +2743,7 @@ struct CtorForwarderProxy<Sig,8>
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 ) : new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7 );
         }
     }
 };
@@ -2740,7 +2788,8 @@ namespace Detail {
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -2788,7 +2837,8 @@ namespace Detail {
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -2838,7 +2888,8 @@ namespace Detail {
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -2898,7 +2949,8 @@ namespace Detail {
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -2967,7 +3019,8 @@ namespace Detail {
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -3027,7 +3080,8 @@ namespace Detail {
 		 AC7 ac7; A7 arg7(ac7.ToNative(argv[7]));
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -3088,7 +3142,7 @@ struct CtorForwarderProxy<Sig,9>
 {
     enum { Arity = 9 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -3127,7 +3181,7 @@ struct CtorForwarderProxy<Sig,9>
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 ) : new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8 );
         }
     }
 };
@@ -3175,7 +3229,8 @@ namespace Detail {
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		 AC9 ac9; A9 arg9(ac9.ToNative(argv[9]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -3226,7 +3281,8 @@ namespace Detail {
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		 AC9 ac9; A9 arg9(ac9.ToNative(argv[9]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
         }
         static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
@@ -3279,7 +3335,8 @@ namespace Detail {
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		 AC9 ac9; A9 arg9(ac9.ToNative(argv[9]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -3342,7 +3399,8 @@ namespace Detail {
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		 AC9 ac9; A9 arg9(ac9.ToNative(argv[9]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
         }
         static v8::Handle<v8::Value> Call( T  & self, FunctionType func, v8::Arguments const & argv )
@@ -3414,7 +3472,8 @@ namespace Detail {
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		 AC9 ac9; A9 arg9(ac9.ToNative(argv[9]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -3477,7 +3536,8 @@ namespace Detail {
 		 AC8 ac8; A8 arg8(ac8.ToNative(argv[8]));
 		 AC9 ac9; A9 arg9(ac9.ToNative(argv[9]));
 		
-            V8Unlocker<UnlockV8> const & unlocker( V8Unlocker<UnlockV8>() );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
             return (ReturnType)(self.*func)(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
         }
         static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
@@ -3538,7 +3598,7 @@ struct CtorForwarderProxy<Sig,10>
 {
     enum { Arity = 10 };
     typedef typename Signature<Sig>::ReturnType ReturnType;
-    static ReturnType Call( v8::Arguments const & argv )
+    static ReturnType Call( v8::Arguments const & argv, void * mem = 0 )
     {
         if( argv.Length() < Arity )
         {
@@ -3580,7 +3640,7 @@ struct CtorForwarderProxy<Sig,10>
 		 AC9 ac9; A9 arg9(ac9.ToNative(argv[9]));
 		
             typedef typename TypeInfo<ReturnType>::Type Type;
-            return new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
+            return mem ? new (mem) Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 ) : new Type(  arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9 );
         }
     }
 };
@@ -0,0 +1,315 @@
+/*
+  Variadic-template implementations of the function forwarders which
+  invocable_generated.hpp otherwise provides for a fixed set of
+  arities: FunctionForwarder, MethodForwarder, ConstMethodForwarder
+  (and their Void variants) and CtorForwarderProxy. Included by
+  invocable_core.hpp, inside the cvv8 namespace, when
+  CVV8_CONFIG_HAS_VARIADIC_TEMPLATES is true.
+
+  Each of these is a definition of the primary template, so it
+  covers every arity not handled by the hand-written 0-arity and
+  InvocationCallback-like specializations.
+*/
+#if !defined(DOXYGEN)
+namespace Detail {
+    /**
+       The type in which ConvertedArg stores a converted argument of
+       type A, given the type R returned by ArgCaster<A>::ToNative().
+
+       Non-reference arguments are converted to A immediately. For
+       reference arguments the result is stored as-is, so that a
+       temporary returned by ToNative() lives until the call is made
+       (as it would for a local reference variable).
+    */
+    template <typename A, typename R>
+    struct ConvertedArgStorage
+    {
+        typedef A Type;
+    };
+    template <typename A, typename R>
+    struct ConvertedArgStorage<A &, R>
+    {
+        typedef R Type;
+    };
+    template <typename A, typename R>
+    struct ConvertedArgStorage<A &, R &>
+    {
+        typedef A & Type;
+    };
+
+    /**
+       Holds the I'th JS argument converted to type A, along with the
+       ArgCaster which converted it (some casters own the memory the
+       converted value refers to).
+
+       The arguments come from argv[I], where ArgSrc is v8::Arguments
+       or any other type whose operator[](int) returns a JS value
+       (see FunctionToBatchInCa).
+    */
+    template <int I, typename A>
+    struct ConvertedArg
+    {
+        typedef ArgCaster<A> CasterType;
+        typedef decltype( std::declval<CasterType &>().ToNative( v8::Handle<v8::Value>() ) ) ResultType;
+        CasterType caster;
+        typename ConvertedArgStorage<A, ResultType>::Type value;
+        template <typename ArgSrc>
+        explicit ConvertedArg( ArgSrc const & argv )
+            : caster(), value( caster.ToNative( argv[I] ) )
+        {}
+    };
+
+    /**
+       Converts all JS arguments for a native function taking (Args...)
+       when it is constructed, in order from left to right (base
+       classes are initialized in declaration order), without any
+       per-argument template recursion.
+    */
+    template <typename IndexListT, typename... Args>
+    struct ConvertedArgs;
+    template <int... I, typename... Args>
+    struct ConvertedArgs< tmp::IndexList<I...>, Args... > : ConvertedArg<I, Args>...
+    {
+        template <typename ArgSrc>
+        explicit ConvertedArgs( ArgSrc const & argv )
+            : ConvertedArg<I, Args>( argv )...
+        {}
+        template <typename RV, typename FuncT>
+        RV CallFunction( FuncT func )
+        {
+            return (RV)(*func)( this->ConvertedArg<I, Args>::value... );
+        }
+        template <typename RV, typename T, typename FuncT>
+        RV CallMethod( T & self, FuncT func )
+        {
+            return (RV)(self.*func)( this->ConvertedArg<I, Args>::value... );
+        }
+        template <typename Type>
+        Type * New( void * mem )
+        {
+            return mem
+                ? new (mem) Type( this->ConvertedArg<I, Args>::value... )
+                : new Type( this->ConvertedArg<I, Args>::value... );
+        }
+    };
+
+    /**
+       Metafunction whose Type is the ConvertedArgs type for the given
+       function or member function pointer type.
+    */
+    template <typename FunctionType>
+    struct ForwarderArgs;
+    template <typename RV, typename... Args>
+    struct ForwarderArgs< RV (*)(Args...) >
+    {
+        typedef ConvertedArgs< typename tmp::MakeIndexList<sizeof...(Args)>::Type, Args... > Type;
+    };
+    template <typename T, typename RV, typename... Args>
+    struct ForwarderArgs< RV (T::*)(Args...) > : ForwarderArgs< RV (*)(Args...) >
+    {};
+    template <typename T, typename RV, typename... Args>
+    struct ForwarderArgs< RV (T::*)(Args...) const > : ForwarderArgs< RV (*)(Args...) >
+    {};
+
+    template <int Arity_, typename Sig, bool UnlockV8>
+    struct FunctionForwarder : FunctionSignature<Sig>
+    {
+        typedef FunctionSignature<Sig> SignatureType;
+        typedef char AssertArity[ (Arity_ == sl::Arity<SignatureType>::Value) ? 1 : -1];
+        typedef typename SignatureType::FunctionType FunctionType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        static ReturnType CallNative( FunctionType func, v8::Arguments const & argv )
+        {
+            typename ForwarderArgs<FunctionType>::Type args( argv );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
+            return args.template CallFunction<ReturnType>( func );
+        }
+        static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
+        {
+            return CastToJS( CallNative( func, argv ) );
+        }
+    };
+
+    template <int Arity_, typename Sig, bool UnlockV8>
+    struct FunctionForwarderVoid : FunctionSignature<Sig>
+    {
+        typedef FunctionSignature<Sig> SignatureType;
+        typedef char AssertArity[ (Arity_ == sl::Arity<SignatureType>::Value) ? 1 : -1];
+        typedef typename SignatureType::FunctionType FunctionType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        static ReturnType CallNative( FunctionType func, v8::Arguments const & argv )
+        {
+            typename ForwarderArgs<FunctionType>::Type args( argv );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
+            return args.template CallFunction<ReturnType>( func );
+        }
+        static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
+        {
+            CallNative( func, argv );
+            return v8::Undefined();
+        }
+    };
+
+    template <typename T, int Arity_, typename Sig, bool UnlockV8>
+    struct MethodForwarder : MethodSignature<T,Sig>
+    {
+        typedef MethodSignature<T,Sig> SignatureType;
+        typedef char AssertArity[ (Arity_ == sl::Arity<SignatureType>::Value) ? 1 : -1];
+        typedef typename SignatureType::FunctionType FunctionType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        static ReturnType CallNative( T & self, FunctionType func, v8::Arguments const & argv )
+        {
+            typename ForwarderArgs<FunctionType>::Type args( argv );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
+            return args.template CallMethod<ReturnType>( self, func );
+        }
+        static v8::Handle<v8::Value> Call( T & self, FunctionType func, v8::Arguments const & argv )
+        {
+            try { return CastToJS( CallNative( self, func, argv ) ); }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+        static ReturnType CallNative( FunctionType func, v8::Arguments const & argv )
+        {
+            T * self = CastFromJS<T>(argv.This());
+            if( ! self ) throw MissingThisExceptionT<T>();
+            return (ReturnType)CallNative(*self, func, argv);
+        }
+        static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
+        {
+            try { return CastToJS( CallNative(func, argv) ); }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+    };
+
+    template <typename T, int Arity_, typename Sig, bool UnlockV8>
+    struct MethodForwarderVoid : MethodSignature<T,Sig>
+    {
+        typedef MethodSignature<T,Sig> SignatureType;
+        typedef char AssertArity[ (Arity_ == sl::Arity<SignatureType>::Value) ? 1 : -1];
+        typedef typename SignatureType::FunctionType FunctionType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        static ReturnType CallNative( T & self, FunctionType func, v8::Arguments const & argv )
+        {
+            typename ForwarderArgs<FunctionType>::Type args( argv );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
+            return args.template CallMethod<ReturnType>( self, func );
+        }
+        static v8::Handle<v8::Value> Call( T & self, FunctionType func, v8::Arguments const & argv )
+        {
+            try
+            {
+                CallNative( self, func, argv );
+                return v8::Undefined();
+            }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+        static ReturnType CallNative( FunctionType func, v8::Arguments const & argv )
+        {
+            T * self = CastFromJS<T>(argv.This());
+            if( ! self ) throw MissingThisExceptionT<T>();
+            return (ReturnType)CallNative(*self, func, argv);
+        }
+        static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
+        {
+            try
+            {
+                CallNative(func, argv);
+                return v8::Undefined();
+            }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+    };
+
+    template <typename T, int Arity_, typename Sig, bool UnlockV8>
+    struct ConstMethodForwarder : ConstMethodSignature<T,Sig>
+    {
+        typedef ConstMethodSignature<T,Sig> SignatureType;
+        typedef char AssertArity[ (Arity_ == sl::Arity<SignatureType>::Value) ? 1 : -1];
+        typedef typename SignatureType::FunctionType FunctionType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        static ReturnType CallNative( T const & self, FunctionType func, v8::Arguments const & argv )
+        {
+            typename ForwarderArgs<FunctionType>::Type args( argv );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
+            return args.template CallMethod<ReturnType>( self, func );
+        }
+        static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
+        {
+            try { return CastToJS( CallNative( self, func, argv ) ); }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+        static ReturnType CallNative( FunctionType func, v8::Arguments const & argv )
+        {
+            T const * self = CastFromJS<T>(argv.This());
+            if( ! self ) throw MissingThisExceptionT<T>();
+            return (ReturnType)CallNative(*self, func, argv);
+        }
+        static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
+        {
+            try { return CastToJS( CallNative(func, argv) ); }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+    };
+
+    template <typename T, int Arity_, typename Sig, bool UnlockV8>
+    struct ConstMethodForwarderVoid : ConstMethodSignature<T,Sig>
+    {
+        typedef ConstMethodSignature<T,Sig> SignatureType;
+        typedef char AssertArity[ (Arity_ == sl::Arity<SignatureType>::Value) ? 1 : -1];
+        typedef typename SignatureType::FunctionType FunctionType;
+        typedef typename SignatureType::ReturnType ReturnType;
+        static ReturnType CallNative( T const & self, FunctionType func, v8::Arguments const & argv )
+        {
+            typename ForwarderArgs<FunctionType>::Type args( argv );
+            ProfilerBodyMark const bodyMark;
+            V8Unlocker<UnlockV8> const unlocker( func );
+            return args.template CallMethod<ReturnType>( self, func );
+        }
+        static v8::Handle<v8::Value> Call( T const & self, FunctionType func, v8::Arguments const & argv )
+        {
+            try
+            {
+                CallNative( self, func, argv );
+                return v8::Undefined();
+            }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+        static ReturnType CallNative( FunctionType func, v8::Arguments const & argv )
+        {
+            T const * self = CastFromJS<T>(argv.This());
+            if( ! self ) throw MissingThisExceptionT<T>();
+            return (ReturnType)CallNative(*self, func, argv);
+        }
+        static v8::Handle<v8::Value> Call( FunctionType func, v8::Arguments const & argv )
+        {
+            try
+            {
+                CallNative(func, argv);
+                return v8::Undefined();
+            }
+            HANDLE_PROPAGATE_EXCEPTION;
+        }
+    };
+
+    template <typename Sig, int Arity>
+    typename CtorForwarderProxy<Sig,Arity>::ReturnType
+    CtorForwarderProxy<Sig,Arity>::Call( v8::Arguments const & argv, void * mem )
+    {
+        if( argv.Length() < Arity )
+        {
+            StringBuffer msg;
+            msg << "CtorForwarder<T," << Arity << ">::Ctor() expects at least "
+                << Arity << " JS arguments!";
+            throw std::range_error(msg.Content().c_str());
+        }
+        typedef typename TypeInfo<ReturnType>::Type Type;
+        typename ForwarderArgs<typename Signature<Sig>::FunctionType>::Type args( argv );
+        return args.template New<Type>( mem );
+    }
+}
+#endif // if !defined(DOXYGEN)
@@ -0,0 +1,413 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_LOCK_STATS_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_LOCK_STATS_HPP_INCLUDED 1
+/*
+  v8 lock contention statistics: how long bindings run with v8
+  unlocked (see the UnlockV8 option of FunctionToInCa and friends),
+  how long they wait to get the lock back, and how long TimedLocker
+  users wait for their v8::Locker. Compiled in only if
+  CVV8_CONFIG_ENABLE_LOCK_STATS is true.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include "profiler.hpp"
+#include "stats_mutex.hpp"
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#if CVV8_CONFIG_ENABLE_LOCK_STATS
+#  include "wall_clock.hpp"
+#endif
+
+namespace cvv8 {
+
+    /**
+       v8 lock statistics. See LockStats. All times are in
+       microseconds.
+    */
+    struct LockStatsRecord
+    {
+        /** The number of buckets in the histograms. */
+        enum { Buckets = 8 };
+        /** Number of times a binding unlocked v8. */
+        std::size_t Unlocks;
+        /** Total time v8 was unlocked by bindings. */
+        double UnlockedUs;
+        /** The longest single unlocked period. */
+        double MaxUnlockedUs;
+        /**
+           Histogram of unlocked periods. Bucket i counts durations
+           shorter than 10^i microseconds (and at least 10^(i-1), for
+           i>0), except for the last one, which counts all longer
+           ones. See LockStats::BucketLabel().
+        */
+        std::size_t UnlockedHistogram[Buckets];
+        /**
+           Total time bindings waited to re-acquire the v8 lock at the
+           end of their unlocked periods. This is the contention cost
+           of unlocking.
+        */
+        double RelockWaitUs;
+        /** The longest single re-acquisition wait. */
+        double MaxRelockWaitUs;
+        /** Histogram of re-acquisition waits, bucketed as above. */
+        std::size_t RelockWaitHistogram[Buckets];
+        /** Number of v8::Lockers acquired through TimedLocker. */
+        std::size_t LockerAcquisitions;
+        /** Total time TimedLockers waited for their v8::Locker. */
+        double LockerWaitUs;
+        /** The longest single v8::Locker wait. */
+        double MaxLockerWaitUs;
+        LockStatsRecord()
+            : Unlocks(0), UnlockedUs(0), MaxUnlockedUs(0),
+              RelockWaitUs(0), MaxRelockWaitUs(0),
+              LockerAcquisitions(0), LockerWaitUs(0), MaxLockerWaitUs(0)
+        {
+            for( int i = 0; i < Buckets; ++i )
+            {
+                UnlockedHistogram[i] = RelockWaitHistogram[i] = 0;
+            }
+        }
+    };
+
+#if !defined(DOXYGEN)
+namespace Detail {
+    /** Shared state of LockStats. */
+    struct LockStatsState
+    {
+        /** Guards all other members. */
+        StatsMutex mutex;
+        LockStatsRecord stats;
+        /** See LockStats::SetDumpInterval(). */
+        double dumpIntervalUs;
+        double lastDumpUs;
+        std::ostream * dumpTo;
+        LockStatsState() : mutex(), stats(), dumpIntervalUs(0), lastDumpUs(0), dumpTo(0) {}
+        static LockStatsState & Instance()
+        {
+            static LockStatsState bob;
+            return bob;
+        }
+    };
+}
+#endif /* DOXYGEN */
+
+    /**
+       Process-wide v8 lock statistics, collected only if the library
+       is compiled with CVV8_CONFIG_ENABLE_LOCK_STATS set to a true
+       value. Otherwise the timing code is compiled out completely and
+       all counters stay at 0.
+
+       Each binding whose UnlockV8 option is in effect records how
+       long it ran with v8 unlocked and how long it then waited to
+       re-acquire the lock (i.e. for other threads to release it). Each
+       TimedLocker records how long it waited for its v8::Locker.
+
+       The JS callbacks are installed by SetupStatsBindings() (see
+       shell_stats.hpp).
+
+       Per-binding figures are recorded by InCaProfiler, if
+       CVV8_CONFIG_ENABLE_PROFILER is enabled as well: the unlocked time
+       of each call is subtracted from its TotalUs to get the time the
+       binding held the v8 lock (see CallProfileStats::HeldUs()).
+
+       The statistics are shared by all isolates (see V8ShellPool),
+       and are guarded by a mutex of their own, so the functions may
+       be called from any thread.
+    */
+    class LockStats
+    {
+    public:
+        /** True if the statistics are compiled in. */
+        enum { Enabled = CVV8_CONFIG_ENABLE_LOCK_STATS };
+
+        /** Returns a copy of the statistics. */
+        static LockStatsRecord Stats()
+        {
+            Detail::LockStatsState & s( Detail::LockStatsState::Instance() );
+            Detail::StatsLock const lk( s.mutex );
+            return s.stats;
+        }
+
+        /** Zeroes all counters. */
+        static void Reset()
+        {
+            Detail::LockStatsState & s( Detail::LockStatsState::Instance() );
+            Detail::StatsLock const lk( s.mutex );
+            s.stats = LockStatsRecord();
+        }
+
+        /**
+           Returns a short label for histogram bucket i, e.g. "<10us",
+           or NULL if i is out of range.
+        */
+        static char const * BucketLabel( int i )
+        {
+            static char const * const labels[LockStatsRecord::Buckets] = {
+                "<1us", "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+            };
+            return ((i < 0) || (i >= LockStatsRecord::Buckets)) ? 0 : labels[i];
+        }
+
+        /** Returns the histogram bucket index for the given duration. */
+        static int BucketFor( double us )
+        {
+            int b = 0;
+            for( double lim = 1; (b < LockStatsRecord::Buckets - 1) && (us >= lim); lim *= 10 ) ++b;
+            return b;
+        }
+
+        /** Returns the statistics as human-readable text. */
+        static std::string ToString()
+        {
+            return ToString( Stats() );
+        }
+
+        /** Returns st as human-readable text. */
+        static std::string ToString( LockStatsRecord const & st )
+        {
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(1)
+               << "unlocks: " << st.Unlocks
+               << ", unlocked: " << st.UnlockedUs << "us (max " << st.MaxUnlockedUs << "us)"
+               << ", relock wait: " << st.RelockWaitUs << "us (max " << st.MaxRelockWaitUs << "us)\n"
+               << "locker acquisitions: " << st.LockerAcquisitions
+               << ", locker wait: " << st.LockerWaitUs << "us (max " << st.MaxLockerWaitUs << "us)\n"
+               << std::left << std::setw(14) << "histogram:" << std::right;
+            for( int i = 0; i < LockStatsRecord::Buckets; ++i )
+            {
+                os << std::setw(10) << BucketLabel(i);
+            }
+            os << '\n' << std::left << std::setw(14) << "  unlocked" << std::right;
+            for( int i = 0; i < LockStatsRecord::Buckets; ++i )
+            {
+                os << std::setw(10) << st.UnlockedHistogram[i];
+            }
+            os << '\n' << std::left << std::setw(14) << "  relock wait" << std::right;
+            for( int i = 0; i < LockStatsRecord::Buckets; ++i )
+            {
+                os << std::setw(10) << st.RelockWaitHistogram[i];
+            }
+            os << '\n';
+            return os.str();
+        }
+
+        /**
+           Returns the statistics as a JS object with the properties
+           (unlocks, unlockedUs, maxUnlockedUs, unlockedHistogram,
+           relockWaitUs, maxRelockWaitUs, relockWaitHistogram,
+           lockerAcquisitions, lockerWaitUs, maxLockerWaitUs). The
+           histograms are objects mapping BucketLabel() values to
+           counts.
+        */
+        static v8::Handle<v8::Object> ToJS()
+        {
+            LockStatsRecord const st( Stats() );
+            v8::HandleScope hsc;
+            v8::Handle<v8::Object> o( v8::Object::New() );
+            v8::Handle<v8::Object> unlocked( v8::Object::New() );
+            v8::Handle<v8::Object> relock( v8::Object::New() );
+            for( int i = 0; i < LockStatsRecord::Buckets; ++i )
+            {
+                v8::Handle<v8::String> const label( v8::String::New( BucketLabel(i) ) );
+                unlocked->Set( label, v8::Number::New( static_cast<double>(st.UnlockedHistogram[i]) ) );
+                relock->Set( label, v8::Number::New( static_cast<double>(st.RelockWaitHistogram[i]) ) );
+            }
+            o->Set( CVV8_SYMBOL("unlocks"), v8::Number::New( static_cast<double>(st.Unlocks) ) );
+            o->Set( CVV8_SYMBOL("unlockedUs"), v8::Number::New( st.UnlockedUs ) );
+            o->Set( CVV8_SYMBOL("maxUnlockedUs"), v8::Number::New( st.MaxUnlockedUs ) );
+            o->Set( CVV8_SYMBOL("unlockedHistogram"), unlocked );
+            o->Set( CVV8_SYMBOL("relockWaitUs"), v8::Number::New( st.RelockWaitUs ) );
+            o->Set( CVV8_SYMBOL("maxRelockWaitUs"), v8::Number::New( st.MaxRelockWaitUs ) );
+            o->Set( CVV8_SYMBOL("relockWaitHistogram"), relock );
+            o->Set( CVV8_SYMBOL("lockerAcquisitions"), v8::Number::New( static_cast<double>(st.LockerAcquisitions) ) );
+            o->Set( CVV8_SYMBOL("lockerWaitUs"), v8::Number::New( st.LockerWaitUs ) );
+            o->Set( CVV8_SYMBOL("maxLockerWaitUs"), v8::Number::New( st.MaxLockerWaitUs ) );
+            return hsc.Close( o );
+        }
+
+        /**
+           Makes the statistics be written to dest (as ToString() does)
+           every intervalSeconds seconds, at the next time a
+           statistic is recorded after the interval expires. A
+           non-positive interval or a NULL dest turns the dump off
+           (the default).
+        */
+        static void SetDumpInterval( double intervalSeconds, std::ostream * dest )
+        {
+            Detail::LockStatsState & s( Detail::LockStatsState::Instance() );
+            Detail::StatsLock const lk( s.mutex );
+            bool const on = dest && (intervalSeconds > 0);
+            s.dumpIntervalUs = on ? intervalSeconds * 1000000.0 : 0;
+            s.dumpTo = on ? dest : 0;
+            s.lastDumpUs = 0;
+        }
+
+        /**
+           v8::InvocationCallback with the JS interface:
+
+           @code
+           Object lockStats([bool reset=false])
+           @endcode
+
+           Returns ToJS(), and then calls Reset() if reset is true.
+        */
+        static v8::Handle<v8::Value> StatsCallback( v8::Arguments const & argv )
+        {
+            v8::Handle<v8::Value> const rc( ToJS() );
+            if( (argv.Length() > 0) && argv[0]->BooleanValue() ) Reset();
+            return rc;
+        }
+
+        /**
+           v8::InvocationCallback which returns ToString() as a JS
+           string.
+        */
+        static v8::Handle<v8::Value> TextCallback( v8::Arguments const & )
+        {
+            std::string const s( ToString() );
+            return v8::String::New( s.c_str(), static_cast<int>(s.size()) );
+        }
+    };
+
+#if !defined(DOXYGEN)
+namespace Detail {
+#if CVV8_CONFIG_ENABLE_LOCK_STATS
+    /** Returns the current time in microseconds, from an arbitrary base. */
+    inline double LockStatsNowUs()
+    {
+        return WallClockUs();
+    }
+
+    /**
+       Writes the periodic dump, if one is due. now is
+       LockStatsNowUs(). The caller must hold s.mutex.
+    */
+    inline void LockStatsMaybeDump( LockStatsState & s, double now )
+    {
+        if( !s.dumpTo ) return;
+        if( !s.lastDumpUs ) s.lastDumpUs = now;
+        else if( (now - s.lastDumpUs) >= s.dumpIntervalUs )
+        {
+            s.lastDumpUs = now;
+            *s.dumpTo << LockStats::ToString( s.stats ) << std::flush;
+        }
+    }
+
+    /**
+       Times one unlocked period of V8Unlocker. Unlocked() must be
+       called after unlocking, Relocking() before re-locking and
+       Relocked() after re-locking, at which point the times are
+       recorded.
+    */
+    class V8UnlockTimer
+    {
+    private:
+        double unlockedAt;
+        double relockAt;
+    public:
+        V8UnlockTimer() : unlockedAt(0), relockAt(0) {}
+        void Unlocked()
+        {
+            unlockedAt = LockStatsNowUs();
+        }
+        void Relocking()
+        {
+            relockAt = LockStatsNowUs();
+        }
+        void Relocked()
+        {
+            double const now = LockStatsNowUs();
+            double const unlocked = relockAt - unlockedAt;
+            double const wait = now - relockAt;
+#  if CVV8_CONFIG_ENABLE_PROFILER
+            ProfileFrame * const f = ProfileFrame::Current();
+            if( f ) f->unlockedUs += now - unlockedAt;
+#  endif
+            LockStatsState & s( LockStatsState::Instance() );
+            StatsLock const lk( s.mutex );
+            LockStatsRecord & st( s.stats );
+            ++st.Unlocks;
+            st.UnlockedUs += unlocked;
+            if( unlocked > st.MaxUnlockedUs ) st.MaxUnlockedUs = unlocked;
+            ++st.UnlockedHistogram[LockStats::BucketFor( unlocked )];
+            st.RelockWaitUs += wait;
+            if( wait > st.MaxRelockWaitUs ) st.MaxRelockWaitUs = wait;
+            ++st.RelockWaitHistogram[LockStats::BucketFor( wait )];
+            LockStatsMaybeDump( s, now );
+        }
+    };
+
+    /**
+       Times the acquisition of TimedLocker's v8::Locker: construct it
+       before acquiring the lock and call Acquired() afterwards.
+    */
+    class V8LockTimer
+    {
+    private:
+        double start;
+    public:
+        V8LockTimer() : start( LockStatsNowUs() ) {}
+        void Acquired()
+        {
+            double const now = LockStatsNowUs();
+            double const wait = now - start;
+            LockStatsState & s( LockStatsState::Instance() );
+            StatsLock const lk( s.mutex );
+            LockStatsRecord & st( s.stats );
+            ++st.LockerAcquisitions;
+            st.LockerWaitUs += wait;
+            if( wait > st.MaxLockerWaitUs ) st.MaxLockerWaitUs = wait;
+            LockStatsMaybeDump( s, now );
+        }
+    };
+#else
+    /** No-op when lock statistics are disabled. */
+    struct V8UnlockTimer
+    {
+        V8UnlockTimer() {}
+        void Unlocked() {}
+        void Relocking() {}
+        void Relocked() {}
+    };
+    /** No-op when lock statistics are disabled. */
+    struct V8LockTimer
+    {
+        V8LockTimer() {}
+        void Acquired() {}
+    };
+#endif /* CVV8_CONFIG_ENABLE_LOCK_STATS */
+}
+#endif /* DOXYGEN */
+
+    /**
+       A v8::Locker which records how long it waited for the lock in
+       LockStats (if that is enabled). Applications which want those
+       figures for their own threads use it in place of v8::Locker,
+       e.g. next to a V8Shell<false>:
+
+       @code
+       cvv8::TimedLocker const lock;
+       cvv8::V8Shell<false> shell;
+       @endcode
+    */
+    class TimedLocker
+    {
+    private:
+        Detail::V8LockTimer timer;
+        v8::Locker lock;
+        TimedLocker( TimedLocker const & );
+        TimedLocker & operator=( TimedLocker const & );
+    public:
+        TimedLocker() : timer(), lock()
+        {
+            timer.Acquired();
+        }
+    };
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_LOCK_STATS_HPP_INCLUDED */
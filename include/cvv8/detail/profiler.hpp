@@ -0,0 +1,251 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_PROFILER_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_PROFILER_HPP_INCLUDED 1
+/*
+  Per-binding call statistics for InvocationCallbacks. The InCa
+  decorator which collects them, InCaProfiler, lives in
+  invocable_core.hpp.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include "stats_mutex.hpp"
+
+#if CVV8_CONFIG_ENABLE_PROFILER
+#  include "wall_clock.hpp"
+#endif
+
+namespace cvv8 {
+
+    /**
+       Call statistics for one InCaProfiler binding. All times are in
+       microseconds.
+    */
+    struct CallProfileStats
+    {
+        /** The binding's name (see InCaProfiler). */
+        char const * Name;
+        /** Number of calls made. */
+        std::size_t Calls;
+        /** Total time spent in the binding, conversions included. */
+        double TotalUs;
+        /** The longest single call. */
+        double MaxUs;
+        /**
+           The part of TotalUs spent in the bound native function
+           itself. For bindings which convert their arguments
+           (FunctionToInCa and friends) the rest of TotalUs is argument
+           and return value conversion (see ConversionUs()). Bindings
+           which do no conversion (e.g. InCaToInCa) count entirely as
+           body time.
+        */
+        double BodyUs;
+        /**
+           The part of TotalUs during which the binding had v8
+           unlocked (see the UnlockV8 option of FunctionToInCa and
+           friends). Only recorded if CVV8_CONFIG_ENABLE_LOCK_STATS is
+           enabled as well, else 0.
+        */
+        double UnlockedUs;
+        CallProfileStats()
+            : Name(0), Calls(0), TotalUs(0), MaxUs(0), BodyUs(0), UnlockedUs(0)
+        {}
+        /** Returns the time spent converting values to/from JS. */
+        double ConversionUs() const
+        {
+            return TotalUs - BodyUs;
+        }
+        /** Returns the time the binding held the v8 lock. */
+        double HeldUs() const
+        {
+            return TotalUs - UnlockedUs;
+        }
+    };
+
+#if !defined(DOXYGEN)
+namespace Detail {
+#if CVV8_CONFIG_ENABLE_PROFILER
+    /** Returns the current time in microseconds, from an arbitrary base. */
+    inline double ProfilerNowUs()
+    {
+        return WallClockUs();
+    }
+
+    /**
+       Per-call state of the innermost active InCaProfiler call on the
+       current thread.
+    */
+    struct ProfileFrame
+    {
+        ProfileFrame * prev;
+        /** Nesting level of ProfilerBodyMark objects. */
+        int depth;
+        /** Number of times the outermost body mark was entered. */
+        int marks;
+        double bodyStart;
+        double bodyUs;
+        /** Time spent with v8 unlocked (see V8UnlockTimer). */
+        double unlockedUs;
+        static ProfileFrame *& Current()
+        {
+            static CVV8_THREAD_LOCAL ProfileFrame * cur = 0;
+            return cur;
+        }
+    };
+
+    /**
+       A sentry which marks the time between its construction and
+       destruction as "native body" time in the current ProfileFrame,
+       if any. Nested marks (e.g. from bindings called by the body)
+       count as part of the outermost one.
+
+       The function forwarders create one of these after converting
+       their arguments and before calling the bound function.
+    */
+    struct ProfilerBodyMark
+    {
+        ProfilerBodyMark()
+        {
+            ProfileFrame * f = ProfileFrame::Current();
+            if( f && (0 == f->depth++) )
+            {
+                ++f->marks;
+                f->bodyStart = ProfilerNowUs();
+            }
+        }
+        ~ProfilerBodyMark()
+        {
+            ProfileFrame * f = ProfileFrame::Current();
+            if( f && (0 == --f->depth) )
+            {
+                f->bodyUs += ProfilerNowUs() - f->bodyStart;
+            }
+        }
+    };
+#else
+    /** No-op when profiling is disabled. */
+    struct ProfilerBodyMark
+    {
+        ProfilerBodyMark() {}
+    };
+#endif /* CVV8_CONFIG_ENABLE_PROFILER */
+}
+#endif /* DOXYGEN */
+
+    /**
+       The registry of all InCaProfiler bindings which have been
+       called at least once.
+
+       All functions require that the caller hold the v8 lock.
+       Mutex(), Records() and Stats() come from Detail::StatsRegistry.
+       If CVV8_CONFIG_ENABLE_PROFILER is false then nothing is ever
+       recorded and the functions report no bindings.
+    */
+    class CallProfiler : public Detail::StatsRegistry<CallProfileStats>
+    {
+    public:
+        /** True if profiling is compiled in. */
+        enum { Enabled = CVV8_CONFIG_ENABLE_PROFILER };
+
+        /** Zeroes the counters of all records. */
+        static void Reset()
+        {
+            Detail::StatsLock const lk( Mutex() );
+            ListType & li( Records() );
+            ListType::iterator it = li.begin();
+            for( ; li.end() != it; ++it )
+            {
+                char const * name = (*it)->Name;
+                **it = CallProfileStats();
+                (*it)->Name = name;
+            }
+        }
+
+        /**
+           Returns all records as a JSON array of objects with the
+           properties (name, calls, totalUs, maxUs, bodyUs,
+           conversionUs, unlockedUs, heldUs).
+        */
+        static std::string ToJSON()
+        {
+            std::vector<CallProfileStats> const li( Stats() );
+            StringBuffer os;
+            os << '[';
+            std::vector<CallProfileStats>::const_iterator it = li.begin();
+            for( ; li.end() != it; ++it )
+            {
+                CallProfileStats const & st( *it );
+                os << ((li.begin() == it) ? "\n" : ",\n") << "{\"name\":\"";
+                for( char const * c = st.Name; *c; ++c )
+                {
+                    if( ('"' == *c) || ('\\' == *c) ) os << '\\' << *c;
+                    else if( static_cast<unsigned char>(*c) < 0x20 ) os << ' ';
+                    else os << *c;
+                }
+                os << "\",\"calls\":" << st.Calls
+                   << ",\"totalUs\":" << st.TotalUs
+                   << ",\"maxUs\":" << st.MaxUs
+                   << ",\"bodyUs\":" << st.BodyUs
+                   << ",\"conversionUs\":" << st.ConversionUs()
+                   << ",\"unlockedUs\":" << st.UnlockedUs
+                   << ",\"heldUs\":" << st.HeldUs()
+                   << '}';
+            }
+            os << (li.empty() ? "]" : "\n]");
+            return os.Content();
+        }
+
+        /**
+           Returns all records as a JS array of objects with the same
+           properties as ToJSON() uses.
+        */
+        static v8::Handle<v8::Array> ToJS()
+        {
+            std::vector<CallProfileStats> const li( Stats() );
+            v8::HandleScope hsc;
+            v8::Handle<v8::Array> ar( v8::Array::New( static_cast<int>(li.size()) ) );
+            for( uint32_t i = 0; i < li.size(); ++i )
+            {
+                CallProfileStats const & st( li[i] );
+                v8::Handle<v8::Object> o( v8::Object::New() );
+                o->Set( CVV8_SYMBOL("name"), v8::String::New( st.Name ) );
+                o->Set( CVV8_SYMBOL("calls"), v8::Number::New( static_cast<double>(st.Calls) ) );
+                o->Set( CVV8_SYMBOL("totalUs"), v8::Number::New( st.TotalUs ) );
+                o->Set( CVV8_SYMBOL("maxUs"), v8::Number::New( st.MaxUs ) );
+                o->Set( CVV8_SYMBOL("bodyUs"), v8::Number::New( st.BodyUs ) );
+                o->Set( CVV8_SYMBOL("conversionUs"), v8::Number::New( st.ConversionUs() ) );
+                o->Set( CVV8_SYMBOL("unlockedUs"), v8::Number::New( st.UnlockedUs ) );
+                o->Set( CVV8_SYMBOL("heldUs"), v8::Number::New( st.HeldUs() ) );
+                ar->Set( i, o );
+            }
+            return hsc.Close( ar );
+        }
+
+        /**
+           v8::InvocationCallback with the JS interface:
+
+           @code
+           Array callProfile([bool reset=false])
+           @endcode
+
+           Returns ToJS(), and then calls Reset() if reset is true.
+        */
+        static v8::Handle<v8::Value> StatsCallback( v8::Arguments const & argv )
+        {
+            v8::Handle<v8::Value> const rc( ToJS() );
+            if( (argv.Length() > 0) && argv[0]->BooleanValue() ) Reset();
+            return rc;
+        }
+
+        /**
+           v8::InvocationCallback which returns ToJSON() as a JS
+           string.
+        */
+        static v8::Handle<v8::Value> JSONCallback( v8::Arguments const & )
+        {
+            return CastToJS( ToJSON() );
+        }
+    };
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_PROFILER_HPP_INCLUDED */
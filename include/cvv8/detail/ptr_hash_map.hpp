@@ -0,0 +1,249 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_PTR_HASH_MAP_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_PTR_HASH_MAP_HPP_INCLUDED 1
+/*
+  A minimal open-addressing hash table keyed on (void const *).
+
+  This code is independent of v8 and of the rest of the library, so
+  that it can be benchmarked and tested without a JS engine.
+
+  License: Dual MIT/Public Domain
+*/
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace cvv8 {
+#if !defined(DOXYGEN)
+namespace Detail {
+
+    /**
+       The default hash function for PtrHashMap keys.
+
+       Heap pointers are almost always aligned to 8 or 16 bytes, so
+       their low bits carry no information. We first fold the upper
+       bits down onto them and then run a multiply/xorshift mix (the
+       64-bit finalizer from MurmurHash3, or its 32-bit counterpart)
+       so that adjacent allocations land in unrelated buckets.
+    */
+    struct PtrHash
+    {
+        std::size_t operator()( void const * p ) const
+        {
+            uintptr_t x = reinterpret_cast<uintptr_t>(p);
+            if( sizeof(uintptr_t) > 4 )
+            {
+                x ^= x >> 33;
+                x *= static_cast<uintptr_t>(0xff51afd7ed558ccdULL);
+                x ^= x >> 33;
+            }
+            else
+            {
+                x ^= x >> 16;
+                x *= static_cast<uintptr_t>(0x85ebca6bUL);
+                x ^= x >> 13;
+            }
+            return static_cast<std::size_t>(x);
+        }
+    };
+
+    /**
+       A cache-friendly open-addressing hash table mapping (void const
+       *) keys to ValueT.
+
+       - Linear probing over a single contiguous slot array, so a
+         lookup typically touches one cache line.
+
+       - The capacity is always a power of two, so the bucket index is
+         a mask instead of a division.
+
+       - Removal uses backward-shift deletion, so there are no
+         tombstones and lookup cost does not degrade over time in
+         insert/remove-heavy workloads (which is what object
+         binding/unbinding looks like).
+
+       The null pointer is reserved as the "empty slot" marker and may
+       not be used as a key.
+
+       HashT must be a default-constructible functor with the
+       signature (std::size_t (void const *)). MaxLoadPercent is the
+       fill ratio (in percent) past which the table doubles in size.
+    */
+    template <typename ValueT,
+              typename HashT = PtrHash,
+              unsigned short MaxLoadPercent = 75>
+    class PtrHashMap
+    {
+    private:
+        typedef char AssertLoadFactor[ ((MaxLoadPercent > 0) && (MaxLoadPercent < 100)) ? 1 : -1 ];
+        struct Slot
+        {
+            void const * key;
+            ValueT value;
+            Slot() : key(0), value() {}
+        };
+        typedef std::vector<Slot> SlotList;
+        SlotList slots;
+        std::size_t count;
+        std::size_t mask;
+        HashT hasher;
+
+        /** Returns the smallest power of two >= n, with a minimum of 8. */
+        static std::size_t roundUp( std::size_t n )
+        {
+            std::size_t rc = 8;
+            while( rc < n ) rc <<= 1;
+            return rc;
+        }
+
+        /** Returns the number of slots required to hold n entries
+            without exceeding MaxLoadPercent. */
+        static std::size_t slotsFor( std::size_t n )
+        {
+            return roundUp( (n * 100) / MaxLoadPercent + 1 );
+        }
+
+        std::size_t bucket( void const * key ) const
+        {
+            return hasher(key) & mask;
+        }
+
+        /** Returns the slot index holding key, or slots.size() if
+            key is not in the table. */
+        std::size_t indexOf( void const * key ) const
+        {
+            if( !key || !count ) return slots.size();
+            std::size_t i = bucket(key);
+            for( ;; i = (i + 1) & mask )
+            {
+                Slot const & s( slots[i] );
+                if( s.key == key ) return i;
+                else if( !s.key ) return slots.size();
+            }
+        }
+
+        /** Resizes to exactly newSize slots (a power of two) and
+            rehashes all entries. */
+        void rehash( std::size_t newSize )
+        {
+            SlotList old( newSize );
+            old.swap( slots );
+            mask = newSize - 1;
+            typename SlotList::iterator it = old.begin();
+            for( ; old.end() != it; ++it )
+            {
+                if( !it->key ) continue;
+                std::size_t i = bucket(it->key);
+                while( slots[i].key ) i = (i + 1) & mask;
+                slots[i] = *it;
+            }
+        }
+
+    public:
+        typedef ValueT ValueType;
+
+        PtrHashMap() : slots(), count(0), mask(0), hasher()
+        {}
+
+        /** Returns the number of entries in the table. */
+        std::size_t Size() const { return count; }
+
+        /** Returns the number of slots currently allocated. */
+        std::size_t Capacity() const { return slots.size(); }
+
+        /**
+           Ensures that at least n entries can be stored without
+           triggering a rehash. Never shrinks the table.
+        */
+        void Reserve( std::size_t n )
+        {
+            std::size_t const want = slotsFor(n);
+            if( want > slots.size() ) rehash( want );
+        }
+
+        /**
+           Returns a pointer to the value mapped to key, or 0 if no
+           such mapping exists. The pointer is invalidated by any
+           subsequent Insert() or Erase().
+        */
+        ValueT * Find( void const * key )
+        {
+            std::size_t const i = indexOf(key);
+            return (slots.size() == i) ? 0 : &slots[i].value;
+        }
+
+        /** Const overload of Find(). */
+        ValueT const * Find( void const * key ) const
+        {
+            std::size_t const i = indexOf(key);
+            return (slots.size() == i) ? 0 : &slots[i].value;
+        }
+
+        /**
+           Maps key to val, replacing any existing mapping. Returns
+           false (and does nothing) if !key, else true.
+        */
+        bool Insert( void const * key, ValueT const & val )
+        {
+            if( !key ) return false;
+            if( ((count + 1) * 100) > (slots.size() * MaxLoadPercent) )
+            {
+                rehash( slots.empty() ? slotsFor(count + 1) : (slots.size() << 1) );
+            }
+            std::size_t i = bucket(key);
+            for( ; slots[i].key; i = (i + 1) & mask )
+            {
+                if( slots[i].key == key )
+                {
+                    slots[i].value = val;
+                    return true;
+                }
+            }
+            slots[i].key = key;
+            slots[i].value = val;
+            ++count;
+            return true;
+        }
+
+        /**
+           Removes any mapping for key. If found and tgt is not null
+           then the mapped value is copied to *tgt before removal.
+           Returns true if a mapping was removed.
+        */
+        bool Erase( void const * key, ValueT * tgt = 0 )
+        {
+            std::size_t i = indexOf(key);
+            if( slots.size() == i ) return false;
+            if( tgt ) *tgt = slots[i].value;
+            /* Backward-shift deletion: pull subsequent entries of the
+               probe run back into the hole as long as doing so does
+               not move them ahead of their home bucket. */
+            std::size_t j = i;
+            for( ;; )
+            {
+                j = (j + 1) & mask;
+                if( !slots[j].key ) break;
+                std::size_t const home = bucket(slots[j].key);
+                if( ((j - home) & mask) >= ((j - i) & mask) )
+                {
+                    slots[i] = slots[j];
+                    i = j;
+                }
+            }
+            slots[i] = Slot();
+            --count;
+            return true;
+        }
+
+        /** Removes all entries but keeps the allocated slots. */
+        void Clear()
+        {
+            SlotList( slots.size() ).swap( slots );
+            count = 0;
+        }
+    };
+
+} // Detail
+#endif // DOXYGEN
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_PTR_HASH_MAP_HPP_INCLUDED */
@@ -18,7 +18,12 @@ function/method signatures as full-fleged types.
     argument lists in a type-rich manner. Most implementations are
     script-generated and accept up to some library-build-time-defined number
     of types in their argument list (the interface guarantees at least 10
-    unless the client builds a custom copy with a smaller limit).
+    unless the client builds a custom copy with a smaller limit). If
+    CVV8_CONFIG_HAS_VARIADIC_TEMPLATES is true then variadic
+    implementations (signature_variadic.hpp) are used instead, which have
+    no such limit and also provide an ArgTypes typedef (a tmp::TypePack
+    of the argument types) which the sl algorithms use to avoid walking
+    the list recursively.
 
     All specializations implement a "type list" interface. The sl namespace
     contains several different compile-time algorithms (sometimes called
@@ -121,7 +126,11 @@ namespace sl {
     */
     template < typename ListT >
     struct Length : tmp::IntVal<
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+            tmp::TypePackOf<ListT>::Type::Length
+#else
             tmp::IsNil<typename ListT::Head>::Value ? 0 : (1 + Length<typename ListT::Tail>::Value)
+#endif
             > {};
 
     //! End-of-list specialization.
@@ -133,10 +142,15 @@ namespace sl {
         if I is out of range.
     */
     template < unsigned short I, typename ListT >
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+    struct At : tmp::PackAt< I, typename tmp::TypePackOf<ListT>::Type >
+    {};
+#else
     struct At : At<I-1, typename ListT::Tail>
     {
         typedef char AssertIndex[ (I >= Length<ListT>::Value) ? -1 : 1 ];
     };
+#endif
 
     //! Beginning-of-list specialization.
     template < typename ListT >
@@ -161,11 +175,19 @@ namespace sl {
         Clients _must not_ pass a value for the 3rd template parameter.
     */
     template < typename T, typename ListT, unsigned short Internal = 0 >
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+    struct Index : tmp::IntVal< (tmp::PackIndex<T, typename tmp::TypePackOf<ListT>::Type>::Value < 0)
+                            ? -1
+                            : (Internal + tmp::PackIndex<T, typename tmp::TypePackOf<ListT>::Type>::Value) >
+    {
+    };
+#else
     struct Index : tmp::IntVal< tmp::SameType<T, typename ListT::Head>::Value
                             ? Internal
                             : Index<T, typename ListT::Tail, Internal+1>::Value>
     {
     };
+#endif
 
     //! End-of-list specialization.
     template < typename T, unsigned short Internal >
@@ -272,6 +294,9 @@ struct Signature<RV (v8::Arguments const &)>
     typedef void Context;
     typedef v8::Arguments const & Head;
     typedef Signature<RV ()> Tail;
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+    typedef tmp::TypePack<v8::Arguments const &> ArgTypes;
+#endif
 };
 
 template <typename RV>
@@ -492,7 +517,11 @@ struct MethodPtr<T const, Sig, FuncPtr> : ConstMethodPtr<T,Sig,FuncPtr>
 };
 #endif
 
-#include "signature_generated.hpp"
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+#  include "signature_variadic.hpp"
+#else
+#  include "signature_generated.hpp"
+#endif
 } // namespaces
 
 #endif /* CODE_GOOGLE_COM_V8_CONVERT_SIGNATURE_CORE_HPP_INCLUDED */
@@ -0,0 +1,90 @@
+/*
+  Variadic-template implementations of the Signature, MethodSignature
+  and ConstMethodSignature specializations which signature_generated.hpp
+  otherwise provides for a fixed set of arities. Included by
+  signature_core.hpp, inside the cvv8 namespace, when
+  CVV8_CONFIG_HAS_VARIADIC_TEMPLATES is true.
+*/
+#if !defined(DOXYGEN)
+namespace Detail {
+    /** Head/Tail typelist interface for Signature<RV (Args...)>. */
+    template <typename RV, typename... Args>
+    struct SignatureList
+    {
+        typedef tmp::NilType Head;
+        typedef Head Tail;
+    };
+    template <typename RV, typename A0, typename... Rest>
+    struct SignatureList<RV, A0, Rest...>
+    {
+        typedef A0 Head;
+        typedef Signature< RV (Rest...) > Tail;
+    };
+}
+
+template <typename RV, typename... Args>
+struct Signature< RV (Args...) > : Detail::SignatureList<RV, Args...>
+{
+    typedef RV ReturnType;
+    enum { IsConst = 0 };
+    typedef void Context;
+    typedef RV (*FunctionType)(Args...);
+    typedef tmp::TypePack<Args...> ArgTypes;
+};
+
+template <typename RV, typename... Args>
+struct Signature< RV (*)(Args...) > : Signature<RV (Args...)>
+{};
+
+template <typename T, typename RV, typename... Args>
+struct Signature< RV (T::*)(Args...) > : Signature<RV (Args...)>
+{
+    typedef T Context;
+    typedef RV (T::*FunctionType)(Args...);
+};
+
+template <typename T, typename RV, typename... Args>
+struct Signature< RV (T::*)(Args...) const > : Signature<RV (Args...)>
+{
+    typedef T const Context;
+    typedef RV (T::*FunctionType)(Args...) const;
+    enum { IsConst = 1 };
+};
+
+template <typename T, typename RV, typename... Args>
+struct MethodSignature< T, RV (Args...) > : Signature< RV (T::*)(Args...) >
+{};
+
+template <typename T, typename RV, typename... Args>
+struct MethodSignature< T, RV (*)(Args...) > : MethodSignature< T, RV (Args...) >
+{};
+
+template <typename T, typename RV, typename... Args>
+struct MethodSignature< T, RV (T::*)(Args...) > :
+    MethodSignature< T, RV (Args...) >
+{};
+
+template <typename T, typename RV, typename... Args>
+struct MethodSignature< T const, RV (Args...) > :
+    ConstMethodSignature< T, RV (Args...) >
+{};
+
+template <typename T, typename RV, typename... Args>
+struct MethodSignature< T const, RV (T::*)(Args...) > :
+    MethodSignature< T const, RV (Args...) >
+{};
+
+template <typename T, typename RV, typename... Args>
+struct MethodSignature< T const, RV (T::*)(Args...) const > :
+    MethodSignature< T const, RV (Args...) >
+{};
+
+template <typename T, typename RV, typename... Args>
+struct ConstMethodSignature< T, RV (Args...) > : Signature< RV (T::*)(Args...) const >
+{};
+
+template <typename T, typename RV, typename... Args>
+struct ConstMethodSignature< T, RV (T::*)(Args...) const > :
+    ConstMethodSignature< T, RV (Args...) >
+{};
+#endif // if !defined(DOXYGEN)
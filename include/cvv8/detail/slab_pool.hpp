@@ -0,0 +1,191 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_SLAB_POOL_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_SLAB_POOL_HPP_INCLUDED 1
+/*
+  A fixed-size-block memory pool used by ClassCreator_Factory_Pooled.
+
+  This code is independent of v8 and of the rest of the library.
+
+  License: Dual MIT/Public Domain
+*/
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace cvv8 {
+
+    /**
+       Statistics for a memory pool used by ClassCreator_Factory_Pooled.
+    */
+    struct PoolStats
+    {
+        /** Size, in bytes, of each block handed out by the pool. */
+        std::size_t BlockSize;
+        /** Number of blocks currently allocated. */
+        std::size_t Live;
+        /** Number of blocks in the free-list, ready for re-use. */
+        std::size_t Free;
+        /** The largest value Live has ever had. */
+        std::size_t HighWater;
+        /** Number of slabs allocated from the system. */
+        std::size_t Slabs;
+        PoolStats() : BlockSize(0), Live(0), Free(0), HighWater(0), Slabs(0)
+        {}
+    };
+
+#if !defined(DOXYGEN)
+namespace Detail {
+
+    /**
+       Rounds N up to the pool size class which holds objects of N
+       bytes: a multiple of twice the pointer size, which satisfies
+       the alignment requirements of all fundamental types on common
+       platforms.
+    */
+    template <std::size_t N>
+    struct PoolSizeClass
+    {
+        enum { Align = 2 * sizeof(void*) };
+        enum { Value = ((N ? N : 1) + Align - 1) / Align * Align };
+    };
+
+    /**
+       A pool of fixed-size (BlockSize bytes) memory blocks.
+
+       Memory is taken from the system in slabs of many blocks at a
+       time and carved up on demand. Freed blocks go to an intrusive
+       free-list and are handed out again (most recently freed
+       first, as that memory is most likely to still be cached)
+       before any new slab memory is touched. Allocation and
+       deallocation are therefore a handful of instructions and never
+       call into the system allocator except when a new slab is
+       needed. Slabs are never returned to the system, so the memory
+       footprint of a pool is bounded by its high-water mark.
+
+       There is one pool per BlockSize, shared by all types in the
+       same size class, unless Tag is used to give a type a pool of
+       its own (as ClassCreator_InlineStorage does).
+
+       This class is not thread-safe. It is intended to be used only
+       from code which holds the v8 lock.
+    */
+    template <std::size_t BlockSize, typename Tag = void>
+    class SlabPool
+    {
+    private:
+        typedef char AssertBlockSize[ (BlockSize >= sizeof(void*)) ? 1 : -1 ];
+        /** Free-list node, stored in the freed blocks themselves. */
+        struct Node { Node * next; };
+        Node * freeList;
+        char * cursor;
+        char * slabEnd;
+        std::vector<void*> slabs;
+        PoolStats stats;
+
+        /** Number of blocks per slab: targets 64kb slabs, min 16 blocks. */
+        enum { SlabBlocks = ((64 * 1024) / BlockSize) > 16 ? ((64 * 1024) / BlockSize) : 16 };
+
+        SlabPool() : freeList(0), cursor(0), slabEnd(0), slabs(), stats()
+        {
+            stats.BlockSize = BlockSize;
+        }
+        ~SlabPool()
+        {
+            /* Only free the slabs if nothing is still using them,
+               so that objects destroyed after this pool (during
+               static destruction) do not touch freed memory. */
+            if( stats.Live ) return;
+            std::vector<void*>::iterator it = slabs.begin();
+            for( ; slabs.end() != it; ++it ) ::operator delete( *it );
+        }
+        SlabPool( SlabPool const & );
+        SlabPool & operator=( SlabPool const & );
+
+        void addSlab()
+        {
+            void * mem = ::operator new( BlockSize * SlabBlocks );
+            slabs.push_back( mem );
+            cursor = static_cast<char*>(mem);
+            slabEnd = cursor + (BlockSize * SlabBlocks);
+            ++stats.Slabs;
+        }
+
+    public:
+        /** Returns the shared instance. */
+        static SlabPool & Instance()
+        {
+            static SlabPool bob;
+            return bob;
+        }
+
+        /**
+           Returns a block of BlockSize bytes. Throws std::bad_alloc
+           if a new slab is needed and cannot be allocated.
+        */
+        void * Allocate()
+        {
+            void * rc;
+            if( freeList )
+            {
+                rc = freeList;
+                freeList = freeList->next;
+                --stats.Free;
+            }
+            else
+            {
+                if( cursor == slabEnd ) addSlab();
+                rc = cursor;
+                cursor += BlockSize;
+            }
+            if( ++stats.Live > stats.HighWater ) stats.HighWater = stats.Live;
+            return rc;
+        }
+
+        /**
+           Returns a block allocated by Allocate() to the pool. Does
+           nothing if p is 0.
+        */
+        void Deallocate( void * p )
+        {
+            if( !p ) return;
+            Node * n = static_cast<Node*>(p);
+            n->next = freeList;
+            freeList = n;
+            --stats.Live;
+            ++stats.Free;
+        }
+
+        /**
+           Ensures that at least n more blocks can be allocated
+           without allocating a new slab.
+        */
+        void Reserve( std::size_t n )
+        {
+            std::size_t avail = stats.Free + static_cast<std::size_t>(slabEnd - cursor) / BlockSize;
+            while( avail < n )
+            {
+                /* Push the remainder of the current slab onto the
+                   free-list before starting a new one. */
+                for( ; cursor != slabEnd; cursor += BlockSize )
+                {
+                    Node * node = reinterpret_cast<Node*>(cursor);
+                    node->next = freeList;
+                    freeList = node;
+                    ++stats.Free;
+                }
+                addSlab();
+                avail += SlabBlocks;
+            }
+        }
+
+        /** Returns the current statistics. */
+        PoolStats Stats() const
+        {
+            return stats;
+        }
+    };
+
+} // Detail
+#endif // DOXYGEN
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_SLAB_POOL_HPP_INCLUDED */
@@ -0,0 +1,101 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_STATS_MUTEX_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_STATS_MUTEX_HPP_INCLUDED 1
+/*
+  Locking for the library's process-wide statistics and counters,
+  which are shared by all isolates (see V8ShellPool), so the v8 lock
+  alone does not serialize access to them, and the registry type the
+  statistics classes share.
+
+  Without C++11 threads (CVV8_CONFIG_HAS_STD_THREAD) the locks compile
+  to no-ops, and the counters are plain values.
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#include <vector>
+#if CVV8_CONFIG_HAS_STD_THREAD
+#  include <atomic>
+#  include <mutex>
+#endif
+
+namespace cvv8 {
+#if !defined(DOXYGEN)
+namespace Detail {
+#if CVV8_CONFIG_HAS_STD_THREAD
+    typedef std::mutex StatsMutex;
+    typedef std::lock_guard<std::mutex> StatsLock;
+    /** Metafunction whose Type is a counter of type T which may be
+        updated from several threads at once. */
+    template <typename T>
+    struct StatsAtomic
+    {
+        typedef std::atomic<T> Type;
+    };
+#else
+    struct StatsMutex
+    {
+        StatsMutex() {}
+    };
+    struct StatsLock
+    {
+        explicit StatsLock( StatsMutex & ) {}
+    };
+    template <typename T>
+    struct StatsAtomic
+    {
+        typedef T Type;
+    };
+#endif
+}
+#endif /* DOXYGEN */
+
+namespace Detail {
+    /**
+       The list of statistics records behind ClassStats, ExternalMemory
+       and CallProfiler, which derive from it. Each record is owned by
+       the per-type (or per-binding) code which registered it and
+       lives until the program exits, and records are listed in the
+       order they were registered.
+
+       The records are shared by all isolates, so they are added,
+       updated and read under Mutex().
+    */
+    template <typename RecordT>
+    struct StatsRegistry
+    {
+        typedef RecordT RecordType;
+        typedef std::vector<RecordT *> ListType;
+
+        /** The mutex which guards Records() and their contents. */
+        static StatsMutex & Mutex()
+        {
+            static StatsMutex bob;
+            return bob;
+        }
+
+        /**
+           Returns all records. Hold Mutex() while using them, or use
+           Stats() instead.
+        */
+        static ListType & Records()
+        {
+            static ListType bob;
+            return bob;
+        }
+
+        /** Returns a copy of all records, taken under Mutex(). */
+        static std::vector<RecordT> Stats()
+        {
+            StatsLock const lk( Mutex() );
+            ListType const & li( Records() );
+            std::vector<RecordT> rc;
+            rc.reserve( li.size() );
+            typename ListType::const_iterator it = li.begin();
+            for( ; li.end() != it; ++it ) rc.push_back( **it );
+            return rc;
+        }
+    };
+}
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_STATS_MUTEX_HPP_INCLUDED */
@@ -0,0 +1,261 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_SYMBOL_CACHE_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_SYMBOL_CACHE_HPP_INCLUDED 1
+/*
+  An interning cache for JS property-name strings.
+
+  License: Dual MIT/Public Domain
+*/
+#include <v8.h>
+#include <cstring>
+#include <map>
+#include "ptr_hash_map.hpp"
+/* This is included by convert_core.hpp, after its configuration
+   macros are defined. */
+#if CVV8_CONFIG_HAS_ISOLATE_LOCKING && CVV8_CONFIG_HAS_STD_THREAD
+#  include <atomic>
+#  include <mutex>
+#endif
+
+namespace cvv8 {
+
+    /**
+       A cache of interned JS strings (v8 "symbols") for use as
+       property names, so that code which sets the same properties
+       over and over (e.g. once per database row or per parser event)
+       does not have to re-create and re-hash the key strings each
+       time.
+
+       Each distinct key string is converted to a v8::String only
+       once and held in a Persistent handle. Lookups are first done by
+       the address of the given (char const *), which is an O(1) hash
+       lookup, and fall back to comparing the string's contents.
+
+       Literal keys should be fetched via the CVV8_SYMBOL() macro,
+       which skips the content check entirely.
+
+       Keys which are not literals may be passed to Get(), but the
+       cache holds at most MaxEntries distinct strings. Past that
+       point, Get() still works but no longer caches new keys.
+
+       All functions require that the caller hold the v8 lock. The
+       cache is shared by all contexts of an isolate. If the library
+       is built with CVV8_CONFIG_HAS_ISOLATE_LOCKING (and C++11
+       threads), each isolate has its own cache, and Clear() must be
+       called in each non-default isolate before it is disposed (see
+       V8ShellPool). Otherwise there is one cache for the default
+       isolate. If v8 is disposed and re-initialized, Clear() must be
+       called in between.
+    */
+    class SymbolCache
+    {
+    private:
+        /** A (pointer,length) key compared by content. */
+        struct Key
+        {
+            char const * str;
+            std::size_t len;
+            Key( char const * s, std::size_t n ) : str(s), len(n) {}
+            bool operator<( Key const & rhs ) const
+            {
+                int const rc = std::memcmp( this->str, rhs.str, (this->len < rhs.len) ? this->len : rhs.len );
+                return rc ? (rc < 0) : (this->len < rhs.len);
+            }
+        };
+        /** Maps key contents (owned copies) to their symbols. */
+        typedef std::map< Key, v8::Persistent<v8::String> > ByContentT;
+        /** Maps key addresses to entries in ByContentT. */
+        typedef Detail::PtrHashMap< ByContentT::value_type const * > ByAddressT;
+        /** The cache of one isolate. */
+        struct Tables
+        {
+            ByContentT byContent;
+            ByAddressT byAddress;
+            Tables() : byContent(), byAddress() {}
+        };
+#if CVV8_CONFIG_HAS_ISOLATE_LOCKING && CVV8_CONFIG_HAS_STD_THREAD
+        /**
+           The caches of all isolates. generation changes whenever a
+           cache is removed, which invalidates the per-thread lookup
+           caches in tables() (isolate addresses may be reused).
+        */
+        struct Isolates
+        {
+            std::mutex mutex;
+            std::map<v8::Isolate *, Tables *> map;
+            std::atomic<unsigned> generation;
+            Isolates() : mutex(), map(), generation(0) {}
+        };
+        static Isolates & isolates()
+        {
+            static Isolates bob;
+            return bob;
+        }
+        /** Returns the current isolate's cache. */
+        static Tables & tables()
+        {
+            static CVV8_THREAD_LOCAL v8::Isolate * lastIso = 0;
+            static CVV8_THREAD_LOCAL Tables * last = 0;
+            static CVV8_THREAD_LOCAL unsigned lastGen = 0;
+            v8::Isolate * const iso = v8::Isolate::GetCurrent();
+            Isolates & is( isolates() );
+            unsigned const gen = is.generation;
+            if( last && (iso == lastIso) && (gen == lastGen) ) return *last;
+            std::lock_guard<std::mutex> const lk( is.mutex );
+            Tables *& t( is.map[iso] );
+            if( !t ) t = new Tables;
+            lastIso = iso;
+            last = t;
+            lastGen = gen;
+            return *t;
+        }
+        /** Forgets the current isolate's (emptied) cache. */
+        static void removeTables()
+        {
+            Isolates & is( isolates() );
+            std::lock_guard<std::mutex> const lk( is.mutex );
+            std::map<v8::Isolate *, Tables *>::iterator it = is.map.find( v8::Isolate::GetCurrent() );
+            if( is.map.end() == it ) return;
+            delete it->second;
+            is.map.erase( it );
+            ++is.generation;
+        }
+#else
+        /** Returns the cache. */
+        static Tables & tables()
+        {
+            static Tables bob;
+            return bob;
+        }
+        static void removeTables()
+        {}
+#endif
+        static ByContentT & byContent()
+        {
+            return tables().byContent;
+        }
+        static ByAddressT & byAddress()
+        {
+            return tables().byAddress;
+        }
+
+        /**
+           Looks up (or creates) the ByContentT entry for the given
+           key. Returns 0 if the cache is full and key is not in it.
+        */
+        static ByContentT::value_type const * intern( char const * key, std::size_t len )
+        {
+            ByContentT & map( byContent() );
+            ByContentT::iterator it = map.find( Key( key, len ) );
+            if( map.end() != it ) return &*it;
+            else if( map.size() >= MaxEntries ) return 0;
+            char * copy = new char[len + 1];
+            std::memcpy( copy, key, len );
+            copy[len] = 0;
+            v8::Persistent<v8::String> const sym( v8::Persistent<v8::String>::New(
+                        v8::String::NewSymbol( copy, static_cast<int>(len) ) ) );
+            return &*map.insert( std::make_pair( Key( copy, len ), sym ) ).first;
+        }
+
+        /**
+           Shared implementation of Get() and GetLiteral(). If
+           checkContent is false then a cache hit by address is
+           trusted without comparing the contents.
+        */
+        static v8::Handle<v8::String> get( char const * key, std::size_t len, bool checkContent )
+        {
+            ByAddressT & addr( byAddress() );
+            ByContentT::value_type const ** e = addr.Find( key );
+            if( e && (!checkContent
+                      || (((*e)->first.len == len) && (0 == std::memcmp( (*e)->first.str, key, len )))) )
+            {
+                return (*e)->second;
+            }
+            ByContentT::value_type const * ent = intern( key, len );
+            if( ! ent )
+            {
+                return v8::String::NewSymbol( key, static_cast<int>(len) );
+            }
+            /* Addresses of non-literal keys need not be stable, so
+               bound the address table's growth. */
+            if( addr.Size() >= (MaxEntries * 2) ) addr.Clear();
+            addr.Insert( key, ent );
+            return ent->second;
+        }
+
+    public:
+        /** The maximum number of distinct strings held in the cache. */
+        enum { MaxEntries = 4096 };
+
+        /**
+           Returns the interned JS string for the first len bytes of
+           key. key must not be 0.
+        */
+        static v8::Handle<v8::String> Get( char const * key, std::size_t len )
+        {
+            return get( key, len, true );
+        }
+
+        /**
+           Returns the interned JS string for the NUL-terminated key.
+           key must not be 0.
+        */
+        static v8::Handle<v8::String> Get( char const * key )
+        {
+            return get( key, std::strlen(key), true );
+        }
+
+        /**
+           Like Get(key,len), but assumes that the bytes at key never
+           change, and skips the content check when key's address is
+           already known. key must point to static storage, e.g. a
+           string literal. Prefer CVV8_SYMBOL() over calling this
+           directly.
+        */
+        static v8::Handle<v8::String> GetLiteral( char const * key, std::size_t len )
+        {
+            return get( key, len, false );
+        }
+
+        /** Returns the number of distinct strings in the cache. */
+        static std::size_t Size()
+        {
+            return byContent().size();
+        }
+
+        /**
+           Disposes all cached symbols of the current isolate and
+           empties its cache.
+        */
+        static void Clear()
+        {
+            Tables & t( tables() );
+            t.byAddress.Clear();
+            ByContentT & map( t.byContent );
+            ByContentT::iterator it = map.begin();
+            for( ; map.end() != it; ++it )
+            {
+                v8::Persistent<v8::String> sym( it->second );
+                sym.Dispose();
+                delete [] it->first.str;
+            }
+            map.clear();
+            removeTables();
+        }
+    };
+
+} // cvv8
+
+/**
+   Expands to a v8::Handle<v8::String> holding the interned JS
+   string for LITERAL, which must be a string literal (anything else
+   causes a compile-time error). Its length is computed at compile
+   time, and after the first call for a given literal it costs a
+   single hash lookup.
+
+   @code
+   obj->Set( CVV8_SYMBOL("length"), v8::Integer::New(n) );
+   @endcode
+*/
+#define CVV8_SYMBOL(LITERAL) ::cvv8::SymbolCache::GetLiteral( "" LITERAL, sizeof(LITERAL) - 1 )
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_SYMBOL_CACHE_HPP_INCLUDED */
@@ -1,6 +1,17 @@
 #ifndef CODE_GOOGLE_COM_P_V8_CONVERT_TMP_HPP_INCLUDED
 #define CODE_GOOGLE_COM_P_V8_CONVERT_TMP_HPP_INCLUDED
 
+#if !defined(CVV8_CONFIG_HAS_VARIADIC_TEMPLATES)
+/* Variadic templates, decltype and constexpr require C++0x (or MSVC 2015+).
+   When enabled, the Signature and function forwarder templates use
+   them in place of the script-generated, fixed-arity specializations. */
+#  if defined(__GXX_EXPERIMENTAL_CXX0X__) || (__cplusplus >= 201103L) || (defined(_MSC_VER) && (_MSC_VER >= 1900))
+#    define CVV8_CONFIG_HAS_VARIADIC_TEMPLATES 1
+#  else
+#    define CVV8_CONFIG_HAS_VARIADIC_TEMPLATES 0
+#  endif
+#endif
+
 namespace cvv8 {
 /**
    The tmp namespace contains code related to template 
@@ -115,6 +126,133 @@ namespace tmp {
     struct IsNil : SameType<T,NilType> {};
 
 
+#if CVV8_CONFIG_HAS_VARIADIC_TEMPLATES
+    /** Holds a list of types as a template parameter pack. */
+    template <typename... Types>
+    struct TypePack
+    {
+        enum { Length = sizeof...(Types) };
+    };
+
+    /** Holds a list of integers as a template parameter pack. */
+    template <int... I>
+    struct IndexList {};
+
+#if !defined(DOXYGEN)
+    template <typename L1, typename L2>
+    struct ConcatIndexList;
+    template <int... I1, int... I2>
+    struct ConcatIndexList< IndexList<I1...>, IndexList<I2...> >
+    {
+        typedef IndexList<I1..., (sizeof...(I1) + I2)...> Type;
+    };
+#endif
+
+    /**
+       Metafunction whose Type is IndexList<0, 1, ... N-1>. The
+       recursion depth is log2(N), not N.
+    */
+    template <int N>
+    struct MakeIndexList
+        : ConcatIndexList< typename MakeIndexList<N/2>::Type,
+                           typename MakeIndexList<N - N/2>::Type >
+    {};
+    template <>
+    struct MakeIndexList<0> { typedef IndexList<> Type; };
+    template <>
+    struct MakeIndexList<1> { typedef IndexList<0> Type; };
+
+    /** Metafunction whose Type is PackT with T prepended to it. */
+    template <typename T, typename PackT>
+    struct PackPushFront;
+    template <typename T, typename... Types>
+    struct PackPushFront< T, TypePack<Types...> >
+    {
+        typedef TypePack<T, Types...> Type;
+    };
+
+#if !defined(DOXYGEN)
+    template <typename T>
+    struct VoidOf { typedef void Type; };
+    template <typename ListT, typename Enable = void>
+    struct TypePackOf;
+    template <typename ListT, bool AtEnd = IsNil<typename ListT::Head>::Value>
+    struct TypePackOfHeadTail
+        : PackPushFront< typename ListT::Head,
+                         typename TypePackOf<typename ListT::Tail>::Type >
+    {};
+    template <typename ListT>
+    struct TypePackOfHeadTail<ListT, true>
+    {
+        typedef TypePack<> Type;
+    };
+#endif
+
+    /**
+       Metafunction whose Type is the TypePack equivalent of the
+       Head/Tail typelist ListT (e.g. a Signature). Lists which
+       provide their pack as an ArgTypes typedef (as the Signature
+       specializations do) cost nothing, others are walked
+       recursively.
+    */
+    template <typename ListT, typename Enable>
+    struct TypePackOf : TypePackOfHeadTail<ListT> {};
+    template <typename ListT>
+    struct TypePackOf< ListT, typename VoidOf<typename ListT::ArgTypes>::Type >
+    {
+        typedef typename ListT::ArgTypes Type;
+    };
+    template <>
+    struct TypePackOf< NilType, void >
+    {
+        typedef TypePack<> Type;
+    };
+
+#if !defined(DOXYGEN)
+    template <int I>
+    struct PackAtSkip { typedef void const volatile * Type; };
+    template <typename IndexListT>
+    struct PackAtPicker;
+    template <int... Skip>
+    struct PackAtPicker< IndexList<Skip...> >
+    {
+        template <typename T>
+        static Identity<T> pick( typename PackAtSkip<Skip>::Type..., Identity<T> *, ... );
+    };
+    inline constexpr int PackFind( int )
+    {
+        return -1;
+    }
+    template <typename... Bools>
+    constexpr int PackFind( int i, bool match, Bools... rest )
+    {
+        return match ? i : PackFind( i + 1, rest... );
+    }
+#endif
+
+    /**
+       Metafunction whose Type is the I'th type in PackT, found
+       without instantiating one template per element. Fails to
+       compile if I is out of range.
+    */
+    template <int I, typename PackT>
+    struct PackAt;
+    template <int I, typename... Types>
+    struct PackAt< I, TypePack<Types...> >
+        : decltype( PackAtPicker< typename MakeIndexList<I>::Type >::pick( static_cast<Identity<Types>*>(0)... ) )
+    {};
+
+    /**
+       Metafunction whose Value is the 0-based index of the first
+       occurrence of T in PackT, or -1 if PackT does not contain T.
+    */
+    template <typename T, typename PackT>
+    struct PackIndex;
+    template <typename T, typename... Types>
+    struct PackIndex< T, TypePack<Types...> >
+        : IntVal< PackFind( 0, SameType<T,Types>::Value... ) >
+    {};
+#endif /* CVV8_CONFIG_HAS_VARIADIC_TEMPLATES */
 
 }} // namespaces
 #endif // CODE_GOOGLE_COM_P_V8_CONVERT_TMP_HPP_INCLUDED
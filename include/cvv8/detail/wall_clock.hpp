@@ -0,0 +1,48 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_WALL_CLOCK_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_WALL_CLOCK_HPP_INCLUDED 1
+/*
+  A monotonic (where available) wall clock for the library's optional
+  timing code (statistics and profiling).
+
+  License: Dual MIT/Public Domain
+*/
+#include "convert_core.hpp"
+#if CVV8_CONFIG_HAS_STD_THREAD
+#  include <chrono>
+#elif defined(_WIN32)
+#  include <sys/timeb.h>
+#else
+#  include <sys/time.h>
+#endif
+
+namespace cvv8 {
+#if !defined(DOXYGEN)
+namespace Detail {
+    /**
+       Returns the current wall-clock time in microseconds, from an
+       arbitrary base. It uses std::chrono::steady_clock if the
+       compiler has C++11 threads, else gettimeofday() (or _ftime()
+       on Windows, which has only millisecond resolution). It must
+       not be std::clock(), which measures CPU time, not elapsed time.
+    */
+    inline double WallClockUs()
+    {
+#if CVV8_CONFIG_HAS_STD_THREAD
+        typedef std::chrono::duration<double, std::micro> US;
+        return std::chrono::duration_cast<US>(
+            std::chrono::steady_clock::now().time_since_epoch() ).count();
+#elif defined(_WIN32)
+        struct _timeb tb;
+        _ftime( &tb );
+        return tb.time * 1000000.0 + tb.millitm * 1000.0;
+#else
+        struct timeval tv;
+        gettimeofday( &tv, 0 );
+        return tv.tv_sec * 1000000.0 + tv.tv_usec;
+#endif
+    }
+}
+#endif /* DOXYGEN */
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_WALL_CLOCK_HPP_INCLUDED */
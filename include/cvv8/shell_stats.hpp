@@ -0,0 +1,59 @@
+#if !defined(CODE_GOOGLE_COM_P_V8_CONVERT_SHELL_STATS_HPP_INCLUDED)
+#define CODE_GOOGLE_COM_P_V8_CONVERT_SHELL_STATS_HPP_INCLUDED 1
+/** @file shell_stats.hpp
+
+    Opt-in JS bindings for the library's optional statistics, for
+    use by shells and other embedding applications. It is kept out
+    of V8Shell.hpp, which depends only on v8 and the STL.
+
+    License: Dual MIT/Public Domain
+*/
+#include "detail/class_stats.hpp"
+#include "detail/lock_stats.hpp"
+
+namespace cvv8 {
+
+    /**
+        Installs the following JS functions in dest:
+
+        If CVV8_CONFIG_ENABLE_CLASS_STATS is true:
+
+        classStats() (see ClassStats::StatsCallback())
+
+        classStatsText() (see ClassStats::TextCallback())
+
+        If CVV8_CONFIG_ENABLE_LOCK_STATS is true:
+
+        lockStats([bool reset]) (see LockStats::StatsCallback())
+
+        lockStatsText() (see LockStats::TextCallback())
+
+        Functions for statistics which are compiled out are not
+        installed, so scripts can check for them by name.
+
+        @code
+        cvv8::Shell shell;
+        shell.SetupDefaultBindings();
+        cvv8::SetupStatsBindings( shell.Global() );
+        @endcode
+    */
+    inline void SetupStatsBindings( v8::Handle<v8::Object> const & dest )
+    {
+#if CVV8_CONFIG_ENABLE_CLASS_STATS
+        dest->Set( v8::String::New( "classStats" ),
+                   v8::FunctionTemplate::New( ClassStats::StatsCallback )->GetFunction() );
+        dest->Set( v8::String::New( "classStatsText" ),
+                   v8::FunctionTemplate::New( ClassStats::TextCallback )->GetFunction() );
+#endif
+#if CVV8_CONFIG_ENABLE_LOCK_STATS
+        dest->Set( v8::String::New( "lockStats" ),
+                   v8::FunctionTemplate::New( LockStats::StatsCallback )->GetFunction() );
+        dest->Set( v8::String::New( "lockStatsText" ),
+                   v8::FunctionTemplate::New( LockStats::TextCallback )->GetFunction() );
+#endif
+        (void)dest;
+    }
+
+} // cvv8
+
+#endif /* CODE_GOOGLE_COM_P_V8_CONVERT_SHELL_STATS_HPP_INCLUDED */
@@ -104,6 +104,8 @@ namespace cvv8 {
 #include "ClassCreator.hpp"
 #include "properties.hpp"
 #include "XTo.hpp"
+#include "batch.hpp"
+#include "StructDescriptor.hpp"
 /** LICENSE
 
     This software's source code, including accompanying documentation and